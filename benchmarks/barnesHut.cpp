@@ -0,0 +1,79 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark_all.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <cstdio>
+#include <random>
+
+#include <glm/vec3.hpp>
+#include <glm/geometric.hpp>
+
+#include <symtensor/fmm/BarnesHut.h>
+
+using namespace symtensor;
+
+TEST_CASE("benchmark: Barnes-Hut opening angle and order", "[FMM]") {
+
+    constexpr std::size_t n = 20'000;
+    float theta = GENERATE(0.3f, 0.5f, 0.7f);
+
+    std::mt19937 generator{0u};
+    std::uniform_real_distribution<float> positionDistribution{-0.5f, 0.5f};
+    std::uniform_real_distribution<float> massDistribution{0.1f, 1.0f};
+    std::vector<glm::vec3> positions{};
+    std::vector<float> masses{};
+    for (std::size_t i = 0; i < n; ++i) {
+        positions.emplace_back(
+                positionDistribution(generator),
+                positionDistribution(generator),
+                positionDistribution(generator)
+        );
+        masses.push_back(massDistribution(generator));
+    }
+    std::vector<glm::vec3> accelerations(n);
+    std::vector<float> potentials(n);
+
+    // The direct sum is only computed for a sample of the particles, its cost is proportional to n * samples
+    constexpr std::size_t samples = 1024;
+    std::vector<glm::vec3> exactAccelerations(samples);
+    for (std::size_t i = 0; i < samples; ++i) {
+        for (std::size_t j = 0; j < n; ++j) {
+            if (i == j) continue;
+            auto R = positions[j] - positions[i];
+            auto r = glm::length(R);
+            exactAccelerations[i] += R * (masses[j] / (r * r * r));
+        }
+    }
+    BENCHMARK("Naive gravity, " + std::to_string(samples) + " of " + std::to_string(n) + " particles") {
+        glm::vec3 total{};
+        for (std::size_t i = 0; i < samples; ++i) {
+            for (std::size_t j = 0; j < n; ++j) {
+                auto R = positions[j] - positions[i];
+                auto r = glm::length(R) + 1e-7f;
+                total += R * (masses[j] / (r * r * r));
+            }
+        }
+        return total;
+    };
+
+    // Each order is labelled with its mean error on the sampled particles, so that cost can be weighed against accuracy
+    [&]<std::size_t... Order>(std::index_sequence<Order...>) {
+        ([&]() {
+            fmm::BarnesHut<Order + 1> solver{theta};
+            solver.solve(positions, masses, accelerations, potentials);
+            float meanError = 0;
+            for (std::size_t i = 0; i < samples; ++i)
+                meanError += glm::length(accelerations[i] - exactAccelerations[i]) /
+                             glm::length(exactAccelerations[i]) / samples;
+            CHECK(meanError < 5e-2f);
+
+            char name[128];
+            std::snprintf(name, sizeof(name), "Barnes-Hut, order %zu, theta %.1f (mean error %.1e)",
+                          Order + 1, theta, meanError);
+            BENCHMARK(name) {
+                solver.solve(positions, masses, accelerations, potentials);
+                return accelerations[0];
+            };
+        }(), ...);
+    }(std::make_index_sequence<4>());
+}
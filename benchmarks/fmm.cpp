@@ -0,0 +1,127 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark_all.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <cmath>
+#include <random>
+
+#include <glm/vec3.hpp>
+#include <glm/geometric.hpp>
+
+#include <symtensor/fmm/BarnesHut.h>
+#include <symtensor/fmm/Solver.h>
+
+using namespace symtensor;
+
+TEST_CASE("benchmark: Fast multipole method", "[FMM]") {
+
+    std::size_t n = GENERATE(10'000, 100'000, 1'000'000);
+
+    std::mt19937 generator{0u};
+    std::uniform_real_distribution<float> positionDistribution{-0.5f, 0.5f};
+    std::uniform_real_distribution<float> massDistribution{0.1f, 1.0f};
+    std::vector<glm::vec3> positions{};
+    std::vector<float> masses{};
+    for (std::size_t i = 0; i < n; ++i) {
+        positions.emplace_back(
+                positionDistribution(generator),
+                positionDistribution(generator),
+                positionDistribution(generator)
+        );
+        masses.push_back(massDistribution(generator));
+    }
+    std::vector<glm::vec3> accelerations(n);
+    std::vector<float> potentials(n);
+
+    // The direct sum is only computed for a sample of the particles, its cost is proportional to n * samples
+    constexpr std::size_t samples = 1024;
+    auto naive_acceleration = [&](std::size_t i) {
+        glm::vec3 acceleration{};
+        for (std::size_t j = 0; j < n; ++j) {
+            auto R = positions[j] - positions[i];
+            auto r = glm::length(R) + 1e-7f;
+            acceleration += R * (masses[j] / (r * r * r));
+        }
+        return acceleration;
+    };
+
+    // Compare the accuracy of the two methods on the sampled particles
+    fmm::Solver<2> solver{0.5f, 32};
+    solver.solve(positions, masses, accelerations, potentials);
+    float meanError = 0;
+    for (std::size_t i = 0; i < samples; ++i) {
+        auto exact = naive_acceleration(i);
+        meanError += glm::length(accelerations[i] - exact) / glm::length(exact) / samples;
+    }
+    CHECK(meanError < 1e-2f);
+
+    BENCHMARK("Naive gravity, " + std::to_string(samples) + " of " + std::to_string(n) + " particles") {
+        glm::vec3 total{};
+        for (std::size_t i = 0; i < samples; ++i) total += naive_acceleration(i);
+        return total;
+    };
+    BENCHMARK("FMM, order 1, " + std::to_string(n) + " particles") {
+        fmm::Solver<1>{0.5f, 32}.solve(positions, masses, accelerations, potentials);
+        return accelerations[0];
+    };
+    BENCHMARK("FMM, order 2, " + std::to_string(n) + " particles") {
+        solver.solve(positions, masses, accelerations, potentials);
+        return accelerations[0];
+    };
+}
+
+TEST_CASE("benchmark: Octree construction", "[FMM]") {
+
+    std::size_t n = GENERATE(1'000'000, 10'000'000);
+
+    std::mt19937 generator{0u};
+    std::uniform_real_distribution<float> positionDistribution{-0.5f, 0.5f};
+    std::vector<glm::vec3> positions{};
+    for (std::size_t i = 0; i < n; ++i)
+        positions.emplace_back(
+                positionDistribution(generator),
+                positionDistribution(generator),
+                positionDistribution(generator)
+        );
+
+    auto &scheduler = fmm::Scheduler::global();
+    BENCHMARK("Octree, " + std::to_string(n) + " particles, " + std::to_string(scheduler.threads()) + " threads") {
+        return fmm::Octree{positions, 32, scheduler}.nodes().size();
+    };
+}
+
+TEST_CASE("benchmark: Strong scaling", "[FMM]") {
+
+    // A Plummer sphere, whose density varies by orders of magnitude between the core and the outskirts
+    constexpr std::size_t n = 200'000;
+    std::mt19937 generator{0u};
+    std::uniform_real_distribution<float> uniform{0.0f, 1.0f};
+    std::normal_distribution<float> normal{};
+    std::vector<glm::vec3> positions{};
+    std::vector<float> masses(n, 1.0f / n);
+    while (positions.size() < n) {
+        float radius = 1.0f / std::sqrt(std::pow(uniform(generator), -2.0f / 3.0f) - 1.0f);
+        if (!std::isfinite(radius) || radius > 20.0f) continue;
+        glm::vec3 direction{normal(generator), normal(generator), normal(generator)};
+        positions.push_back(glm::normalize(direction) * radius);
+    }
+    std::vector<glm::vec3> accelerations(n);
+    std::vector<float> potentials(n);
+
+    // Powers of two up to the number of cores, and the number of cores itself
+    std::vector<std::size_t> threadCounts{};
+    for (std::size_t threads = 1; threads < fmm::concurrency(); threads *= 2) threadCounts.push_back(threads);
+    threadCounts.push_back(fmm::concurrency());
+
+    for (auto threads: threadCounts) {
+        fmm::Scheduler scheduler{threads};
+        BENCHMARK("FMM, order 2, " + std::to_string(threads) + " threads") {
+            fmm::Solver<2>{0.5f, 32, scheduler}.solve(positions, masses, accelerations, potentials);
+            return accelerations[0];
+        };
+        BENCHMARK("Barnes-Hut, order 2, " + std::to_string(threads) + " threads") {
+            fmm::BarnesHut<2>{0.5f, 16, scheduler}.solve(positions, masses, accelerations, potentials);
+            return accelerations[0];
+        };
+    }
+}
@@ -13,6 +13,7 @@
 #include "symtensor/gravity/direct.h"
 #include "symtensor/gravity/einsum.h"
 #include "symtensor/gravity/tensorlib.h"
+#include "symtensor/gravity/kernels.h"
 #include "symtensor/glm.h"
 
 using namespace symtensor;
@@ -34,17 +35,21 @@ TEST_CASE("benchmark: Multipole moment gravity approximation", "[Gravity]") {
                 massDistribution(generator)
         );
 
-    // Produce a multipole from the points
-    float totalMass = 0;
-    auto quadrupole = std::transform_reduce(
+    // Produce a multipole from the points, about the origin
+    auto moment = std::transform_reduce(
             particles.begin(), particles.end(),
             QuadrupoleMoment3f{}, std::plus<>{},
             [&](auto particle) {
-                totalMass += particle.w;
                 return QuadrupoleMoment3f::FromPosition(glm::vec3{particle}) * particle.w;
             }
-    ) / totalMass;
-    // todo: recenter on COM
+    );
+
+    // Recenter on the center of mass, where the dipole vanishes;
+    // the first-order tensor is then used to hold the center itself
+    SymmetricTensor3f<1> centerOfMass = moment.tensor<1>() / moment.scalar();
+    auto centeredMoment = moment.translated(-to_glm(centerOfMass));
+    auto quadrupole = centeredMoment;
+    quadrupole.tensor<1>() = centerOfMass;
 
 
     auto naive_acceleration = [](std::span<glm::vec4> particles, glm::vec3 position) {
@@ -87,4 +92,70 @@ TEST_CASE("benchmark: Multipole moment gravity approximation", "[Gravity]") {
             meter.measure([&] { return quadrupole_acceleration(quadrupole, position); });
         };
 
+
+    auto m2l_acceleration = [&](glm::vec3 position) {
+        LocalExpansion3f<1> local{};
+        gravity::multipoleToLocal(local, centeredMoment, position - to_glm(centerOfMass));
+        return to_glm(local.tensor<1>());
+    };
+    CHECK(glm::length(m2l_acceleration(glm::vec3{5, 0, 0}) - quadrupole_acceleration(quadrupole, glm::vec3{5, 0, 0})) <
+          1e-5f * glm::length(m2l_acceleration(glm::vec3{5, 0, 0})));
+
+    // Calculate gravity with the multipole-to-local kernel
+    BENCHMARK_ADVANCED("Quadrupole Gravity (M2L)")(Catch::Benchmark::Chronometer meter) {
+            auto position = glm::vec3{
+                    positionDistribution(generator) * 10,
+                    positionDistribution(generator) * 10,
+                    positionDistribution(generator) * 10,
+            };
+            meter.measure([&] { return m2l_acceleration(position); });
+        };
+
+}
+
+TEST_CASE("benchmark: Local expansion evaluation", "[Gravity]") {
+
+    std::mt19937 generator{0u};
+    std::uniform_real_distribution<float> distribution{-0.5f, 0.5f};
+    auto center = glm::vec3{0.1f, 0.2f, 0.3f};
+    std::vector<glm::vec3> positions{};
+    for (int i = 0; i < 4096; ++i)
+        positions.emplace_back(distribution(generator), distribution(generator), distribution(generator));
+
+    LocalExpansion3f<3> local{};
+    auto moment = OctupoleMoment3f::FromPosition(glm::vec3{0.5f, 0.25f, 0.125f});
+    gravity::multipoleToLocal<gravity::Direct>(local, QuadrupoleMoment3f{
+            moment.scalar(), moment.tensor<1>(), moment.tensor<2>()
+    }, glm::vec3{6, -4, 5});
+
+    // Contracting each tensor with the cartesian powers of each offset, one particle at a time
+    auto perParticle = [&](std::span<glm::vec3> accelerations, std::span<float> potentials) {
+        for (std::size_t i = 0; i < positions.size(); ++i) {
+            auto x = positions[i] - center;
+            auto x2 = SymmetricTensor3f<2>::CartesianPower(x);
+            auto x3 = SymmetricTensor3f<3>::CartesianPower(x);
+            potentials[i] += local.scalar() + local.tensor<1>() * SymmetricTensor3f<1>::CartesianPower(x) +
+                             local.tensor<2>() * x2 / 2.0f + local.tensor<3>() * x3 / 6.0f;
+            accelerations[i] += to_glm(local.tensor<1>()) +
+                                to_glm(local.tensor<2>() * SymmetricTensor3f<1>::CartesianPower(x)) +
+                                to_glm(local.tensor<3>() * x2) / 2.0f;
+        }
+    };
+
+    std::vector<glm::vec3> accelerations(positions.size()), expectedAccelerations(positions.size());
+    std::vector<float> potentials(positions.size()), expectedPotentials(positions.size());
+    local.evaluate(center, std::span<const glm::vec3>{positions}, std::span{accelerations}, std::span{potentials});
+    perParticle(expectedAccelerations, expectedPotentials);
+    for (std::size_t i = 0; i < positions.size(); ++i)
+        REQUIRE(glm::length(accelerations[i] - expectedAccelerations[i]) <
+                1e-5f * glm::length(expectedAccelerations[i]));
+
+    BENCHMARK("L2P, 4096 particles (per particle)") {
+        perParticle(accelerations, potentials);
+        return potentials[0];
+    };
+    BENCHMARK("L2P, 4096 particles (batched)") {
+        local.evaluate(center, std::span<const glm::vec3>{positions}, std::span{accelerations}, std::span{potentials});
+        return potentials[0];
+    };
 }
@@ -4,11 +4,16 @@
 #include <glm/vec3.hpp>
 #include <glm/geometric.hpp>
 
+#include <experimental/simd>
+#include <random>
+
 #include <symtensor/Multipole.h>
+#include <symtensor/MultipoleMoment.h>
 
 #include "symtensor/gravity/direct.h"
 #include "symtensor/gravity/einsum.h"
 #include "symtensor/gravity/tensorlib.h"
+#include "symtensor/gravity/kernels.h"
 
 using namespace symtensor;
 
@@ -45,9 +50,147 @@ TEST_CASE("benchmark: Gravity derivatives construction", "[Gravity]") {
     BENCHMARK("D' - D'''' (tensorlib)") { return gravity::tensorlib::derivatives<4>(R); };
 
     BENCHMARK("D' - D''''' (direct)") { return gravity::direct::derivatives<5>(R); };
-    //BENCHMARK("D' - D''''' (einsum)") { return gravity::einsum::derivatives<5>(R); }; // todo: unimplemented
+    BENCHMARK("D' - D''''' (einsum)") { return gravity::einsum::derivatives<5>(R); };
     BENCHMARK("D' - D''''' (tensorlib)") { return gravity::tensorlib::derivatives<5>(R); };
 
+    BENCHMARK("D1-8 (einsum)") { return gravity::einsum::derivatives<8>(R); };
+    BENCHMARK("D1-8 (tensorlib)") { return gravity::tensorlib::derivatives<8>(R); };
+    BENCHMARK("D1-10 (einsum)") { return gravity::einsum::derivatives<10>(R); };
+    BENCHMARK("D1-10 (tensorlib)") { return gravity::tensorlib::derivatives<10>(R); };
+
     //    BENCHMARK("D1-5 Construction (direct)") { return gravity::direct::derivatives<5>(R); };
     //    BENCHMARK("D1-5 Construction (tensorlib)") { return gravity::tensorlib::derivatives<5>(R); };
 }
+
+TEST_CASE("benchmark: Gravity derivatives precision", "[Gravity]") {
+    const auto R = glm::vec3{1.0, 2.0, 3.0};
+    const auto R_double = glm::dvec3{R};
+
+    // Each backend in single precision, double precision, and computed in double but stored in single precision
+    BENCHMARK("D' - D''''' (direct, float)") { return gravity::Direct::derivatives<5>(R); };
+    BENCHMARK("D' - D''''' (direct, double)") { return gravity::Direct::derivatives<5>(R_double); };
+    BENCHMARK("D' - D''''' (direct, mixed)") { return gravity::MixedPrecision<gravity::Direct>::derivatives<5>(R); };
+    BENCHMARK("D' - D''''' (einsum, float)") { return gravity::Einsum::derivatives<5>(R); };
+    BENCHMARK("D' - D''''' (einsum, double)") { return gravity::Einsum::derivatives<5>(R_double); };
+    BENCHMARK("D' - D''''' (einsum, mixed)") { return gravity::MixedPrecision<gravity::Einsum>::derivatives<5>(R); };
+    BENCHMARK("D' - D''''' (tensorlib, float)") { return gravity::Tensorlib::derivatives<5>(R); };
+    BENCHMARK("D' - D''''' (tensorlib, double)") { return gravity::Tensorlib::derivatives<5>(R_double); };
+    BENCHMARK("D' - D''''' (tensorlib, mixed)") {
+        return gravity::MixedPrecision<gravity::Tensorlib>::derivatives<5>(R);
+    };
+}
+
+TEST_CASE("benchmark: Softened gravity derivatives", "[Gravity]") {
+    const auto R = glm::vec3{0.1, 0.2, 0.3};
+
+    using SimdScalar = std::experimental::native_simd<float>;
+    using SimdVector = SymmetricTensor<SimdScalar, 3, 1>;
+
+    // Lanes on either side of the softening length, so that the spline takes more than one branch
+    auto R_simd = SimdVector::NullaryExpression([&](auto index) {
+        return SimdScalar{[&](auto lane) { return R[static_cast<int>(index[0])] * static_cast<float>(lane + 1); }};
+    });
+
+    BENCHMARK("D' - D''''' (newtonian)") { return gravity::einsum::derivatives<5>(R); };
+    BENCHMARK("D' - D''''' (plummer)") { return gravity::plummer::derivatives<5>(R, 0.3f); };
+    BENCHMARK("D' - D''''' (spline)") { return gravity::spline::derivatives<5>(R, 1.0f); };
+    BENCHMARK("D' - D''''' (newtonian, batched)") { return gravity::einsum::derivatives<5>(R_simd); };
+    BENCHMARK("D' - D''''' (plummer, batched)") { return gravity::plummer::derivatives<5>(R_simd, SimdScalar{0.3f}); };
+    BENCHMARK("D' - D''''' (spline, batched)") { return gravity::spline::derivatives<5>(R_simd, SimdScalar{1.0f}); };
+}
+
+TEST_CASE("benchmark: Radial potential derivatives", "[Gravity]") {
+    const auto R = glm::vec3{1.0, 2.0, 3.0};
+
+    // The same tensor assembly, with the radial factors of each potential
+    BENCHMARK("D' - D''''' (newtonian, einsum)") { return gravity::einsum::derivatives<5>(R); };
+    BENCHMARK("D' - D''''' (newtonian, tensorlib)") { return gravity::tensorlib::derivatives<5>(R); };
+    BENCHMARK("D' - D''''' (yukawa, einsum)") {
+        return gravity::einsum::derivatives<5>(R, gravity::radial::Yukawa{0.5f});
+    };
+    BENCHMARK("D' - D''''' (yukawa, tensorlib)") {
+        return gravity::tensorlib::derivatives<5>(R, gravity::radial::Yukawa{0.5f});
+    };
+    BENCHMARK("D' - D''''' (erfc, einsum)") {
+        return gravity::einsum::derivatives<5>(R, gravity::radial::ShortRange{0.5f});
+    };
+    BENCHMARK("D' - D''''' (erfc, tensorlib)") {
+        return gravity::tensorlib::derivatives<5>(R, gravity::radial::ShortRange{0.5f});
+    };
+}
+
+TEST_CASE("benchmark: Batched gravity derivatives construction", "[Gravity]") {
+
+    using SimdScalar = std::experimental::native_simd<float>;
+    using SimdVector = SymmetricTensor<SimdScalar, 3, 1>;
+    static constexpr std::size_t simd_size = SimdScalar::size();
+
+    // One separation vector per lane
+    std::array<glm::vec3, simd_size> R{};
+    for (std::size_t lane = 0; lane < simd_size; ++lane)
+        R[lane] = glm::vec3{1.0, 2.0, 3.0} + static_cast<float>(lane);
+    auto R_simd = SimdVector::NullaryExpression([&](auto index) {
+        return SimdScalar{[&](auto lane) { return R[lane][static_cast<int>(index[0])]; }};
+    });
+
+    // Every lane must match the scalar derivative for the same vector
+    auto direct = gravity::direct::derivative<4>(R_simd);
+    auto einsum = gravity::einsum::derivative<4>(R_simd);
+    for (std::size_t lane = 0; lane < simd_size; ++lane) {
+        auto lane_of = [&](const auto &tensor) {
+            return SymmetricTensor3f<4>::NullaryExpression([&]<auto index>() {
+                return tensor.template at<index>()[lane];
+            });
+        };
+        CHECK((lane_of(direct) - gravity::direct::derivative<4>(R[lane])).norm() < 1e-7);
+        CHECK((lane_of(einsum) - gravity::einsum::derivative<4>(R[lane])).norm() < 1e-7);
+    }
+
+    BENCHMARK("D' - D'''' (direct, sequential)") {
+        std::array<decltype(gravity::direct::derivatives<4>(R[0])), simd_size> result;
+        for (std::size_t lane = 0; lane < simd_size; ++lane)
+            result[lane] = gravity::direct::derivatives<4>(R[lane]);
+        return result;
+    };
+    BENCHMARK("D' - D'''' (direct, std::simd)") { return gravity::direct::derivatives<4>(R_simd); };
+    BENCHMARK("D' - D'''' (einsum, sequential)") {
+        std::array<decltype(gravity::einsum::derivatives<4>(R[0])), simd_size> result;
+        for (std::size_t lane = 0; lane < simd_size; ++lane)
+            result[lane] = gravity::einsum::derivatives<4>(R[lane]);
+        return result;
+    };
+    BENCHMARK("D' - D'''' (einsum, std::simd)") { return gravity::einsum::derivatives<4>(R_simd); };
+}
+
+TEST_CASE("benchmark: Multipole moment translation", "[MultipoleMoment]") {
+
+    // A cluster of particles, summarized about its own center
+    std::mt19937 generator{0u};
+    std::uniform_real_distribution<float> positionDistribution{-0.5f, 0.5f};
+    std::vector<glm::vec3> positions{};
+    for (int i = 0; i < 32; ++i)
+        positions.emplace_back(
+                positionDistribution(generator),
+                positionDistribution(generator),
+                positionDistribution(generator)
+        );
+    auto offset = glm::vec3{0.25f, -0.25f, 0.25f};
+
+    auto compare = [&]<typename Moment>(Moment, const std::string &name) {
+        auto fromParticles = [&](glm::vec3 center) {
+            Moment moment{};
+            for (const auto &position: positions) moment += Moment::FromPosition(position + center);
+            return moment;
+        };
+        auto child = fromParticles({});
+        CHECK((child.translated(offset).template tensor<Moment::Order>() -
+               fromParticles(offset).template tensor<Moment::Order>()).norm() < 1e-3);
+
+        BENCHMARK(name + " (from 32 particles)") { return fromParticles(offset); };
+        BENCHMARK(name + " (translated)") { return child.translated(offset); };
+    };
+    compare(QuadrupoleMoment3f{}, "Quadrupole");
+    compare(OctupoleMoment3f{}, "Octupole");
+    compare(HexadecupoleMoment3f{}, "Hexadecupole");
+    compare(TriacontadyupoleMoment3f{}, "Triacontadyupole");
+}
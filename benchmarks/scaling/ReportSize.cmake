@@ -0,0 +1,4 @@
+# Prints the size of a binary, invoked after building each scaling benchmark
+file(SIZE "${TARGET_FILE}" size)
+get_filename_component(name "${TARGET_FILE}" NAME)
+message(STATUS "${name}: ${size} bytes")
@@ -0,0 +1,39 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark_all.hpp>
+
+#include <symtensor/SymmetricTensor.h>
+
+#include <string>
+
+using namespace symtensor;
+
+// Each configuration is compiled separately, so that compile time and binary size can be measured,
+// see benchmarks/scaling/CMakeLists.txt
+#ifndef SCALING_DIMENSIONS
+#define SCALING_DIMENSIONS 3
+#endif
+#ifndef SCALING_RANK
+#define SCALING_RANK 6
+#endif
+
+TEST_CASE("benchmark: Scaling with dimension and rank", "[SymmetricTensor]") {
+
+    constexpr std::size_t D = SCALING_DIMENSIONS;
+    constexpr std::size_t R = SCALING_RANK;
+    using Tensor = SymmetricTensor<float, D, R>;
+    using HalfRankTensor = SymmetricTensor<float, D, R / 2>;
+    using Vector = SymmetricTensor<float, D, 1>;
+
+    auto a = Tensor::NullaryExpression([](auto _) { return static_cast<float>(std::rand()) / RAND_MAX; });
+    auto b = Tensor::NullaryExpression([](auto _) { return static_cast<float>(std::rand()) / RAND_MAX; });
+    auto h = HalfRankTensor::NullaryExpression([](auto _) { return static_cast<float>(std::rand()) / RAND_MAX; });
+    auto v = Vector::NullaryExpression([](auto _) { return static_cast<float>(std::rand()) / RAND_MAX; });
+    Tensor c{};
+
+    std::string name = "D=" + std::to_string(D) + ", R=" + std::to_string(R) + ": ";
+    BENCHMARK(name + "CartesianPower(v)") { return Tensor::CartesianPower(v); };
+    BENCHMARK(name + "a + b * s") { return c = a + b * 2.0f; };
+    BENCHMARK(name + "norm2(a)") { return a.norm2(); };
+    BENCHMARK(name + "a * v") { return a * v; };
+    BENCHMARK(name + "a * h") { return a * h; };
+}
@@ -2,12 +2,17 @@
 #include <catch2/benchmark/catch_benchmark_all.hpp>
 
 #include <symtensor/SymmetricTensor.h>
+#include <symtensor/SymmetricTensorArray.h>
+#include <symtensor/TracelessSymmetricTensor.h>
 
 #include <glm/vec3.hpp>
 #include <glm/matrix.hpp>
 
 #include <iostream>
 #include <numeric>
+#include <span>
+#include <string>
+#include <vector>
 
 #include <experimental/simd>
 
@@ -88,6 +93,25 @@ TEST_CASE("benchmark: Member access", "[SymmetricTensor]") {
 }
 
 
+TEST_CASE("benchmark: Runtime indexing of index streams", "[SymmetricTensor]") {
+
+    using Hexadecupole = SymmetricTensor3f<4>;
+    std::vector<std::array<Hexadecupole::Index, 4>> indices(1024);
+    for (auto &index: indices)
+        index = Hexadecupole::lexicographicalIndices(std::rand() % Hexadecupole::NumValues);
+    std::vector<std::size_t> flatIndices(indices.size());
+
+    BENCHMARK("flatIndex(st3^4 index) (recursive)") {
+        for (std::size_t i = 0; i < indices.size(); ++i)
+            flatIndices[i] = flatIndex(indices[i], 3);
+        return flatIndices.back();
+    };
+    BENCHMARK("flatIndices(st3^4 indices) (tabulated)") {
+        Hexadecupole::flatIndices(indices, flatIndices);
+        return flatIndices.back();
+    };
+}
+
 TEST_CASE("benchmark: Tensor properties", "[SymmetricTensor]") {
 
     {
@@ -109,19 +133,41 @@ TEST_CASE("benchmark: Tensor properties", "[SymmetricTensor]") {
     }
 }
 
+TEST_CASE("benchmark: Tensor norm", "[SymmetricTensor]") {
+
+    [&]<std::size_t... R>(std::index_sequence<R...>) {
+        ([&]<std::size_t Rank>(std::integral_constant<std::size_t, Rank>) {
+            using Tensor = SymmetricTensor3f<Rank>;
+            auto a = Tensor::NullaryExpression([](auto _) { return std::rand(); });
+
+            // Every lexicographical index is visited, as norm2() used to do
+            auto lexicographical = [&] {
+                return [&]<std::size_t... i>(std::index_sequence<i...>) {
+                    return ((a.template at<Tensor::lexicographicalIndices(i)>() *
+                             a.template at<Tensor::lexicographicalIndices(i)>()) + ...);
+                }(std::make_index_sequence<Tensor::NumValues>());
+            };
+
+            std::string name = "norm2(st3^" + std::to_string(Rank) + ")";
+            BENCHMARK(name + " (lexicographical)") { return lexicographical(); };
+            BENCHMARK(name + " (deduplicated)") { return a.norm2(); };
+        }(std::integral_constant<std::size_t, R + 2>{}), ...);
+    }(std::make_index_sequence<7>());
+}
+
 TEST_CASE("benchmark: Tensor arithmetic", "[SymmetricTensor]") {
 
     {
         SymmetricTensor3f<1> a{0, 1, 2};
         glm::vec3 glm_a{0, 1, 2};
-        BENCHMARK("v3 = v3 + v3") { return a + a; };
+        BENCHMARK("v3 = v3 + v3") { return SymmetricTensor3f<1>{a + a}; };
         BENCHMARK("v3 = v3 + v3 (glm)") { return glm_a + glm_a; };
     }
 
     {
         SymmetricTensor3f<2> a{0, 1, 2, 3, 4, 5};
         glm::mat3x3 glm_a{0, 1, 2, 3, 4, 5, 6, 7, 8};
-        BENCHMARK("st3x3 = st3x3 + st3x3") { return a + a; };
+        BENCHMARK("st3x3 = st3x3 + st3x3") { return SymmetricTensor3f<2>{a + a}; };
         BENCHMARK("st3x3 = st3x3 + st3x3 (handwritten") {
                                                             return SymmetricTensor3f<2>{a[0] + a[0], a[1] + a[1],
                                                                                         a[2] + a[2], a[3] + a[3],
@@ -131,51 +177,284 @@ TEST_CASE("benchmark: Tensor arithmetic", "[SymmetricTensor]") {
     }
 }
 
-//TEST_CASE("benchmark: Batched tensor arithmetic", "[SymmetricTensor]") {
-//
-//    static const std::size_t N = 1024;
-//
-//    using SimdScalar = std::experimental::native_simd<float>;
-//    using SimdSymmetricTensor3f3 = SymmetricTensor<SimdScalar, 3, 3>;
-//    static const std::size_t simd_size = SimdScalar::size();
-//
-//
-//    std::vector<SymmetricTensor3f<3>> a{N}, b{N}, c{N};
-//    for (int i = 0; i < N; ++i) {
-//        a.push_back(SymmetricTensor3f<3>::NullaryExpression([](auto _) { return std::rand(); }));
-//        b.push_back(SymmetricTensor3f<3>::NullaryExpression([](auto _) { return std::rand(); }));
-//    }
-//
-//    BENCHMARK("st3x3 = st3x3 + st3x3 (sequential)") {
-//                                                        for (int i = 0; i < N; ++i) {
-//                                                            c[i] = a[i] + b[i];
-//                                                        }
-//                                                        return c;
-//                                                    };
-//
-//    auto to_simd = [](std::span<SymmetricTensor3f<3>, SimdScalar::size()> tensors) -> SimdSymmetricTensor3f3 {
-//        return SimdSymmetricTensor3f3::NullaryExpression([&]<auto index>() {
-//            return SimdScalar{[&]<std::size_t i>(std::integral_constant<std::size_t, i>) {
-//                return tensors[i].at<index>();
-//            }};
-//        });
-//    };
-//
-//    BENCHMARK("st3x3 = st3x3 + st3x3 (std::simd)") {
-//                                                       for (int i = 0; i < N; i += SimdScalar::size()) {
-//                                                           std::span<SymmetricTensor3f<3>, SimdScalar::size()> a_span{
-//                                                                   a.begin() + i, SimdScalar::size()
-//                                                           };
-//                                                           std::span<SymmetricTensor3f<3>, SimdScalar::size()> b_span{
-//                                                                   b.begin() + i, SimdScalar::size()
-//                                                           };
-////                                                           auto c_simd = to_simd(a_span) + to_simd(b_span);
-////                                                           c[i] = a[i] + b[i];
-//                                                       }
-//                                                       return c;
-//                                                   };
-//
-//}
+TEST_CASE("benchmark: Lazy tensor expressions", "[SymmetricTensor]") {
+
+    [&]<std::size_t... R>(std::index_sequence<R...>) {
+        ([&]<std::size_t Rank>(std::integral_constant<std::size_t, Rank>) {
+            using Tensor = SymmetricTensor3f<Rank>;
+            auto a = Tensor::NullaryExpression([](auto _) { return std::rand(); });
+            auto b = Tensor::NullaryExpression([](auto _) { return std::rand(); });
+            auto c = Tensor::NullaryExpression([](auto _) { return std::rand(); });
+            Tensor d{};
+
+            // Every intermediate result is evaluated into a temporary, as the operators used to do
+            auto eager = [&] {
+                Tensor b2 = b * 2.0f;
+                Tensor ab2 = a + b2;
+                Tensor c3 = c / 3.0f;
+                Tensor ab2c3 = ab2 - c3;
+                return Tensor{ab2c3 + a};
+            };
+            REQUIRE(eager() == Tensor{a + b * 2.0f - c / 3.0f + a});
+
+            std::string name = "st3^" + std::to_string(Rank) + " = a + b * s - c / s + a";
+            BENCHMARK(name + " (eager)") { return d = eager(); };
+            BENCHMARK(name + " (lazy)") { return d = a + b * 2.0f - c / 3.0f + a; };
+        }(std::integral_constant<std::size_t, R + 3>{}), ...);
+    }(std::make_index_sequence<6>());
+}
+
+TEST_CASE("benchmark: Tensor contraction", "[SymmetricTensor]") {
+
+    [&]<std::size_t... R>(std::index_sequence<R...>) {
+        ([&]<std::size_t Rank>(std::integral_constant<std::size_t, Rank>) {
+            using Tensor = SymmetricTensor3f<Rank>;
+            using OtherTensor = SymmetricTensor3f<Rank / 2>;
+            using ProductTensor = SymmetricTensor3f<Rank - Rank / 2>;
+            auto a = Tensor::NullaryExpression([](auto _) { return std::rand(); });
+            auto b = OtherTensor::NullaryExpression([](auto _) { return std::rand(); });
+
+            // Every lexicographical index of a is visited, as the operator used to do
+            auto lexicographical = [&] {
+                ProductTensor product{};
+                [&]<std::size_t... i>(std::index_sequence<i...>) {
+                    ((product.template at<head<Index<3>, Rank, Rank - Rank / 2>(Tensor::lexicographicalIndices(i))>() +=
+                              a.template at<Tensor::lexicographicalIndices(i)>() *
+                              b.template at<tail<Index<3>, Rank, Rank / 2>(Tensor::lexicographicalIndices(i))>()), ...);
+                }(std::make_index_sequence<Tensor::NumValues>());
+                return product;
+            };
+
+            std::string name = "st3^" + std::to_string(Rank) + " * st3^" + std::to_string(Rank / 2);
+            BENCHMARK(name + " (lexicographical)") { return lexicographical(); };
+            BENCHMARK(name + " (unique)") { return a * b; };
+        }(std::integral_constant<std::size_t, R + 2>{}), ...);
+    }(std::make_index_sequence<7>());
+}
+
+TEST_CASE("benchmark: Tensor contraction with a vector", "[SymmetricTensor]") {
+
+    glm::vec3 x{std::rand(), std::rand(), std::rand()};
+
+    [&]<std::size_t... R>(std::index_sequence<R...>) {
+        ([&]<std::size_t Rank>(std::integral_constant<std::size_t, Rank>) {
+            using Tensor = SymmetricTensor3f<Rank>;
+            auto a = Tensor::NullaryExpression([](auto _) { return std::rand(); });
+
+            std::string name = "st3^" + std::to_string(Rank) + " * x^";
+            BENCHMARK(name + std::to_string(Rank)) { return a.template contract<Rank>(x); };
+            BENCHMARK(name + std::to_string(Rank) + " (cartesian power)") { return a * Tensor::CartesianPower(x); };
+            BENCHMARK(name + std::to_string(Rank - 1)) { return a.template contract<Rank - 1>(x); };
+            BENCHMARK(name + std::to_string(Rank - 1) + " (cartesian power)") {
+                return a * NextLowerRank<Tensor>::CartesianPower(x);
+            };
+        }(std::integral_constant<std::size_t, R + 2>{}), ...);
+    }(std::make_index_sequence<7>());
+
+    auto a = SymmetricTensor3f<4>::NullaryExpression([](auto _) { return std::rand(); });
+    std::vector<glm::vec3> points(1024);
+    for (auto &p: points) p = {std::rand(), std::rand(), std::rand()};
+    std::vector<float> results(points.size());
+    BENCHMARK("st3^4 * x^4, for 1024 points") {
+        a.contract<4>(std::span<const glm::vec3>{points}, std::span<float>{results});
+        return results.back();
+    };
+}
+
+TEST_CASE("benchmark: Symmetric outer product", "[SymmetricTensor]") {
+
+    [&]<std::size_t... R>(std::index_sequence<R...>) {
+        ([&]<std::size_t Rank>(std::integral_constant<std::size_t, Rank>) {
+            using TensorA = SymmetricTensor3f<Rank / 2>;
+            using TensorB = SymmetricTensor3f<Rank - Rank / 2>;
+            using ProductTensor = SymmetricTensor3f<Rank>;
+            auto a = TensorA::NullaryExpression([](auto _) { return std::rand(); });
+            auto b = TensorB::NullaryExpression([](auto _) { return std::rand(); });
+
+            BENCHMARK("SymmetricOuterProduct(st3^" + std::to_string(Rank / 2) + ", st3^" +
+                      std::to_string(Rank - Rank / 2) + ")") {
+                return ProductTensor::SymmetricOuterProduct(a, b);
+            };
+        }(std::integral_constant<std::size_t, R + 2>{}), ...);
+    }(std::make_index_sequence<7>());
+}
+
+TEST_CASE("benchmark: Partial trace", "[SymmetricTensor]") {
+#if (__cpp_using_enum && !__clang__) || (__clang_major__ > 15)
+    using enum SymmetricTensor3f<1>::Index;
+#else
+    using Index<3>::X;
+    using Index<3>::Y;
+    using Index<3>::Z;
+#endif
+
+    {
+        auto a = SymmetricTensor3f<4>::NullaryExpression([](auto _) { return std::rand(); });
+        BENCHMARK("trace<1>(st3^4)") { return a.trace<1>(); };
+        BENCHMARK("trace<1>(st3^4) (handwritten)") {
+            return SymmetricTensor3f<2>{
+                    a.at<X, X, X, X>() + a.at<X, X, Y, Y>() + a.at<X, X, Z, Z>(),
+                    a.at<X, Y, X, X>() + a.at<X, Y, Y, Y>() + a.at<X, Y, Z, Z>(),
+                    a.at<X, Z, X, X>() + a.at<X, Z, Y, Y>() + a.at<X, Z, Z, Z>(),
+                    a.at<Y, Y, X, X>() + a.at<Y, Y, Y, Y>() + a.at<Y, Y, Z, Z>(),
+                    a.at<Y, Z, X, X>() + a.at<Y, Z, Y, Y>() + a.at<Y, Z, Z, Z>(),
+                    a.at<Z, Z, X, X>() + a.at<Z, Z, Y, Y>() + a.at<Z, Z, Z, Z>()
+            };
+        };
+        BENCHMARK("trace<2>(st3^4)") { return a.trace<2>(); };
+        BENCHMARK("trace<2>(st3^4) (handwritten)") {
+            return a.at<X, X, X, X>() + a.at<Y, Y, Y, Y>() + a.at<Z, Z, Z, Z>() +
+                   2.0f * (a.at<X, X, Y, Y>() + a.at<X, X, Z, Z>() + a.at<Y, Y, Z, Z>());
+        };
+    }
+
+    [&]<std::size_t... R>(std::index_sequence<R...>) {
+        ([&]<std::size_t Rank>(std::integral_constant<std::size_t, Rank>) {
+            auto a = SymmetricTensor3f<Rank>::NullaryExpression([](auto _) { return std::rand(); });
+            BENCHMARK("trace<1>(st3^" + std::to_string(Rank) + ")") { return a.template trace<1>(); };
+            BENCHMARK("trace<2>(st3^" + std::to_string(Rank) + ")") { return a.template trace<2>(); };
+        }(std::integral_constant<std::size_t, R + 5>{}), ...);
+    }(std::make_index_sequence<4>());
+}
+
+TEST_CASE("benchmark: Traceless part of a tensor", "[SymmetricTensor]") {
+
+    {
+        auto a = SymmetricTensor3f<2>::NullaryExpression([](auto _) { return std::rand(); });
+        BENCHMARK("detrace(st3x3)") { return a.detrace(); };
+        BENCHMARK("detrace(st3x3) (handwritten)") {
+            return (a - SymmetricTensor3f<2>::Identity() * ((a[0] + a[3] + a[5]) / 3.0f)).eval();
+        };
+    }
+
+    [&]<std::size_t... R>(std::index_sequence<R...>) {
+        ([&]<std::size_t Rank>(std::integral_constant<std::size_t, Rank>) {
+            auto a = SymmetricTensor3f<Rank>::NullaryExpression([](auto _) { return std::rand(); });
+            BENCHMARK("detrace(st3^" + std::to_string(Rank) + ")") { return a.detrace(); };
+        }(std::integral_constant<std::size_t, R + 3>{}), ...);
+    }(std::make_index_sequence<6>());
+}
+
+TEST_CASE("benchmark: Traceless tensor compression", "[TracelessSymmetricTensor]") {
+
+    [&]<std::size_t... R>(std::index_sequence<R...>) {
+        ([&]<std::size_t Rank>(std::integral_constant<std::size_t, Rank>) {
+            auto a = SymmetricTensor3f<Rank>::NullaryExpression([](auto _) { return std::rand(); }).detrace();
+            auto compressed = TracelessSymmetricTensor3f<Rank>{a};
+            BENCHMARK("TracelessSymmetricTensor3f<" + std::to_string(Rank) + ">(st3^" + std::to_string(Rank) + ")") {
+                return TracelessSymmetricTensor3f<Rank>{a};
+            };
+            BENCHMARK("TracelessSymmetricTensor3f<" + std::to_string(Rank) + ">::expanded()") {
+                return compressed.expanded();
+            };
+        }(std::integral_constant<std::size_t, R + 2>{}), ...);
+    }(std::make_index_sequence<7>());
+}
+
+TEST_CASE("benchmark: Structure-of-arrays tensor arithmetic", "[SymmetricTensorArray]") {
+
+    static const std::size_t N = 1024;
+
+    std::vector<SymmetricTensor3f<3>> a, b;
+    for (std::size_t i = 0; i < N; ++i) {
+        a.push_back(SymmetricTensor3f<3>::NullaryExpression([](auto) { return float(std::rand()); }));
+        b.push_back(SymmetricTensor3f<3>::NullaryExpression([](auto) { return float(std::rand()); }));
+    }
+    SymmetricTensorArray3f<3> a_soa{std::span<const SymmetricTensor3f<3>>{a}};
+    SymmetricTensorArray3f<3> b_soa{std::span<const SymmetricTensor3f<3>>{b}};
+
+    BENCHMARK("st3x3x3 += st3x3x3 (array of structures)") {
+                                                              for (std::size_t i = 0; i < N; ++i)
+                                                                  a[i] += b[i];
+                                                              return a[0];
+                                                          };
+    BENCHMARK("st3x3x3 += st3x3x3 (structure of arrays)") {
+                                                              a_soa += b_soa;
+                                                              return a_soa.at<Index<3>::X, Index<3>::X, Index<3>::X>(0);
+                                                          };
+    BENCHMARK("sum(st3x3x3) (array of structures)") { return std::reduce(a.begin(), a.end()); };
+    BENCHMARK("sum(st3x3x3) (structure of arrays)") { return a_soa.sum(); };
+}
+
+TEST_CASE("benchmark: Batched tensor arithmetic", "[SymmetricTensor]") {
+
+    static const std::size_t N = 1024;
+
+    using SimdScalar = std::experimental::native_simd<float>;
+    using SimdSymmetricTensor3f3 = SymmetricTensor<SimdScalar, 3, 3>;
+    static constexpr std::size_t simd_size = SimdScalar::size();
+
+    std::vector<SymmetricTensor3f<3>> a{}, b{}, c{N};
+    for (std::size_t i = 0; i < N; ++i) {
+        a.push_back(SymmetricTensor3f<3>::NullaryExpression([](auto _) { return std::rand(); }));
+        b.push_back(SymmetricTensor3f<3>::NullaryExpression([](auto _) { return std::rand(); }));
+    }
+
+    auto to_simd = [](std::span<const SymmetricTensor3f<3>, simd_size> tensors) -> SimdSymmetricTensor3f3 {
+        return SimdSymmetricTensor3f3::NullaryExpression([&]<auto index>() {
+            return SimdScalar{[&](auto lane) { return tensors[lane].template at<index>(); }};
+        });
+    };
+    auto from_simd = [](const SimdSymmetricTensor3f3 &tensor, std::span<SymmetricTensor3f<3>, simd_size> tensors) {
+        for (std::size_t lane = 0; lane < simd_size; ++lane)
+            tensors[lane] = SymmetricTensor3f<3>::NullaryExpression([&]<auto index>() {
+                return tensor.at<index>()[lane];
+            });
+    };
+
+    // Each simd tensor packs simd_size consecutive tensors
+    std::vector<SimdSymmetricTensor3f3> a_simd{}, b_simd{}, c_simd{N / simd_size};
+    for (std::size_t i = 0; i < N; i += simd_size) {
+        a_simd.push_back(to_simd(std::span<const SymmetricTensor3f<3>, simd_size>{a.begin() + i, simd_size}));
+        b_simd.push_back(to_simd(std::span<const SymmetricTensor3f<3>, simd_size>{b.begin() + i, simd_size}));
+    }
+
+    // The batched result must match the sequential one
+    for (std::size_t i = 0; i < N; i += simd_size) {
+        from_simd(a_simd[i / simd_size] + b_simd[i / simd_size],
+                  std::span<SymmetricTensor3f<3>, simd_size>{c.begin() + i, simd_size});
+        for (std::size_t lane = 0; lane < simd_size; ++lane)
+            REQUIRE(c[i + lane] == a[i + lane] + b[i + lane]);
+    }
+
+    BENCHMARK("st3x3 = st3x3 + st3x3 (sequential)") {
+        for (std::size_t i = 0; i < N; ++i)
+            c[i] = a[i] + b[i];
+        return c;
+    };
+
+    BENCHMARK("st3x3 = st3x3 + st3x3 (std::simd)") {
+        for (std::size_t i = 0; i < N / simd_size; ++i)
+            c_simd[i] = a_simd[i] + b_simd[i];
+        return c_simd;
+    };
+
+    BENCHMARK("st3x3 = st3x3 + st3x3 (std::simd, including packing)") {
+        for (std::size_t i = 0; i < N; i += simd_size) {
+            from_simd(
+                    to_simd(std::span<const SymmetricTensor3f<3>, simd_size>{a.begin() + i, simd_size}) +
+                    to_simd(std::span<const SymmetricTensor3f<3>, simd_size>{b.begin() + i, simd_size}),
+                    std::span<SymmetricTensor3f<3>, simd_size>{c.begin() + i, simd_size}
+            );
+        }
+        return c;
+    };
+
+    BENCHMARK("|st3x3| (sequential)") {
+        float sum = 0;
+        for (std::size_t i = 0; i < N; ++i)
+            sum += a[i].norm2();
+        return sum;
+    };
+
+    BENCHMARK("|st3x3| (std::simd)") {
+        SimdScalar sum = 0;
+        for (std::size_t i = 0; i < N / simd_size; ++i)
+            sum += a_simd[i].norm2();
+        return reduce(sum);
+    };
+
+}
 
 TEST_CASE("benchmark: Tensor products", "[SymmetricTensor]") {
 
@@ -0,0 +1,218 @@
+/**
+ * @file
+ * @brief Generates straight-line kernels for the derivatives of radial potentials.
+ *
+ * Usage: symtensor-kernel-generator <output header> <max order>
+ *
+ * The element of the rank-N derivative with n_d indices along each axis d is
+ * \f[ \sum_p g_{N - |p|}(r) \prod_d \binom{n_d}{2 p_d} (2 p_d - 1)!! R_d^{n_d - 2 p_d} \f]
+ * where \f$ g_m = (\frac{1}{r} \frac{d}{dr})^m \phi \f$ are the radial factors of the potential
+ * (see gravity::radial). The factors are inputs of the kernels, so one kernel serves every potential.
+ * For each dimension and order, two kernels are written: one producing every rank from 1 to N,
+ * and one producing only rank N.
+ * Within a kernel, the monomials of the coordinates and their products with the radial factors
+ * are each computed once and shared by every element which needs them.
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+    using Exponents = std::vector<std::size_t>;
+
+    std::size_t binomial(std::size_t n, std::size_t k) {
+        std::size_t result = 1;
+        for (std::size_t i = 1; i <= k; ++i) result = result * (n - k + i) / i;
+        return result;
+    }
+
+    std::size_t doubleFactorial(std::ptrdiff_t n) {
+        return n <= 0 ? 1 : static_cast<std::size_t>(n) * doubleFactorial(n - 2);
+    }
+
+    // The unique elements of a symmetric tensor, in the order they are stored by SymmetricTensor:
+    // non-decreasing indices, in lexicographical order. Each is described by the number of indices along each axis.
+    std::vector<Exponents> uniqueElements(std::size_t dimensions, std::size_t rank) {
+        std::vector<Exponents> elements;
+        std::vector<std::size_t> index(rank, 0);
+        while (true) {
+            Exponents counts(dimensions, 0);
+            for (auto i: index) ++counts[i];
+            elements.push_back(counts);
+
+            // Advance to the next non-decreasing index
+            std::size_t r = rank;
+            while (r > 0 && index[r - 1] == dimensions - 1) --r;
+            if (r == 0) break;
+            ++index[r - 1];
+            for (std::size_t s = r; s < rank; ++s) index[s] = index[r - 1];
+        }
+        return elements;
+    }
+
+    std::string suffix(const Exponents &exponents) {
+        std::string result;
+        for (auto e: exponents) {
+            result += '_';
+            result += std::to_string(e);
+        }
+        return result;
+    }
+
+    // Writes the body of one kernel, declaring each shared value the first time it is needed
+    class KernelWriter {
+    private:
+
+        std::size_t _dimensions;
+        bool _singleRank;
+        std::ostringstream _body;
+        std::map<Exponents, std::string> _monomials;
+        std::map<std::pair<std::size_t, Exponents>, std::string> _products;
+
+    public:
+
+        KernelWriter(std::size_t dimensions, bool singleRank) :
+                _dimensions(dimensions), _singleRank(singleRank) {}
+
+        void element(std::size_t rank, std::size_t flatIndex, const Exponents &counts) {
+            std::vector<std::pair<std::size_t, std::string>> terms;
+            Exponents pairs(_dimensions, 0);
+            while (true) {
+                std::size_t coefficient = 1, order = rank;
+                Exponents exponents(_dimensions);
+                for (std::size_t d = 0; d < _dimensions; ++d) {
+                    coefficient *= binomial(counts[d], 2 * pairs[d]) *
+                                   doubleFactorial(2 * static_cast<std::ptrdiff_t>(pairs[d]) - 1);
+                    order -= pairs[d];
+                    exponents[d] = counts[d] - 2 * pairs[d];
+                }
+                terms.emplace_back(coefficient, product(order, exponents));
+
+                // Advance to the next number of pairs along each axis
+                std::size_t d = 0;
+                while (d < _dimensions && 2 * (pairs[d] + 1) > counts[d]) pairs[d++] = 0;
+                if (d == _dimensions) break;
+                ++pairs[d];
+            }
+
+            if (_singleRank)
+                _body << "            D[" << flatIndex << "] = ";
+            else
+                _body << "            D.template tensor<" << rank << ">()[" << flatIndex << "] = ";
+            for (std::size_t t = 0; t < terms.size(); ++t) {
+                _body << (t ? " + " : "");
+                if (terms[t].first != 1) _body << "Scalar(" << terms[t].first << ") * ";
+                _body << terms[t].second;
+            }
+            _body << ";\n";
+        }
+
+        std::string body() const { return _body.str(); }
+
+    private:
+
+        // R_0^e_0 * R_1^e_1 * ..., built by multiplying a lower monomial by one coordinate
+        std::string monomial(const Exponents &exponents) {
+            if (auto it = _monomials.find(exponents); it != _monomials.end()) return it->second;
+
+            std::size_t d = 0;
+            while (exponents[d] == 0) ++d;
+            Exponents lower = exponents;
+            --lower[d];
+            if (std::all_of(lower.begin(), lower.end(), [](auto e) { return e == 0; })) {
+                std::string name = "R[";
+                name += std::to_string(d);
+                name += ']';
+                return _monomials[exponents] = name;
+            }
+
+            const std::string factor = monomial(lower);
+            std::string name = "m";
+            name += suffix(exponents);
+            _body << "            const Scalar " << name << " = " << factor << " * R[" << d << "];\n";
+            return _monomials[exponents] = name;
+        }
+
+        // g_order * monomial
+        std::string product(std::size_t order, const Exponents &exponents) {
+            std::string g = "g[";
+            g += std::to_string(order);
+            g += ']';
+            if (std::all_of(exponents.begin(), exponents.end(), [](auto e) { return e == 0; })) return g;
+            if (auto it = _products.find({order, exponents}); it != _products.end()) return it->second;
+
+            const std::string factor = monomial(exponents);
+            std::string name = "p";
+            name += std::to_string(order);
+            name += suffix(exponents);
+            _body << "            const Scalar " << name << " = " << g << " * " << factor << ";\n";
+            return _products[{order, exponents}] = name;
+        }
+    };
+
+    // Writes a kernel for the derivatives of ranks 1 to N, or only of rank N
+    void writeKernel(std::ostream &out, std::size_t dimensions, std::size_t N, bool singleRank) {
+        KernelWriter writer{dimensions, singleRank};
+        std::size_t count = 0;
+        for (std::size_t rank = singleRank ? N : 1; rank <= N; ++rank) {
+            const auto elements = uniqueElements(dimensions, rank);
+            for (std::size_t i = 0; i < elements.size(); ++i)
+                writer.element(rank, i, elements[i]);
+            count += elements.size();
+        }
+
+        out << "    template<>\n";
+        out << "    struct " << (singleRank ? "DerivativeKernel" : "DerivativesKernel")
+            << "<" << dimensions << ", " << N << "> {\n";
+        out << "        static constexpr std::size_t NumValues = " << count << ";\n\n";
+        out << "        template<typename Scalar, typename Vector, typename RadialFactors, typename Derivatives>\n";
+        out << "        ALWAYS_INLINE static void evaluate(const Vector &R, const RadialFactors &g, Derivatives &D) {\n";
+        out << writer.body();
+        out << "        }\n";
+        out << "    };\n\n";
+    }
+
+}
+
+int main(int argc, char **argv) {
+    if (argc != 3) {
+        std::cerr << "Usage: " << argv[0] << " <output header> <max order>\n";
+        return 1;
+    }
+    const std::size_t maxOrder = std::stoul(argv[2]);
+
+    std::ofstream out{argv[1]};
+    if (!out) {
+        std::cerr << "Could not open " << argv[1] << " for writing\n";
+        return 1;
+    }
+
+    out << "#pragma once\n\n";
+    out << "// Generated by symtensor-kernel-generator, do not edit.\n\n";
+    out << "#include <cstddef>\n\n";
+    out << "#include \"symtensor/platform.h\"\n\n";
+    out << "namespace symtensor::gravity::generated {\n\n";
+    out << "    /// The highest order for which kernels were generated\n";
+    out << "    inline constexpr std::size_t MaxOrder = " << maxOrder << ";\n\n";
+    out << "    /// Writes the derivatives of every rank from 1 to N into the multipole D, given the radial factors g_0 to g_N\n";
+    out << "    template<std::size_t Dimensions, std::size_t N>\n";
+    out << "    struct DerivativesKernel;\n\n";
+    out << "    /// Writes the derivative of rank N into the symmetric tensor D, given the radial factors g_0 to g_N\n";
+    out << "    template<std::size_t Dimensions, std::size_t N>\n";
+    out << "    struct DerivativeKernel;\n\n";
+    for (std::size_t dimensions: {2, 3}) {
+        for (std::size_t order = 1; order <= maxOrder; ++order) {
+            writeKernel(out, dimensions, order, false);
+            writeKernel(out, dimensions, order, true);
+        }
+    }
+    out << "}\n";
+    return out ? 0 : 1;
+}
@@ -6,6 +6,7 @@
 #define SYMTENSOR_INDEX_H
 
 #include <cstddef>
+#include <cstdint>
 #include <array>
 #include <algorithm>
 #include <iterator>
@@ -254,6 +255,146 @@ namespace symtensor {
         }
     }
 
+    namespace {
+
+        template<std::size_t D, std::size_t R>
+        consteval std::array<std::array<std::size_t, D>, R> flatIndexOffsetTable() {
+            // offsets[k][v] counts the canonical indices which match up to position k,
+            // but have a value lower than v at position k (and no lower than its predecessor).
+            // Each of those is followed by (R - k - 1) values in the range [u, D), where u is its value at k.
+            std::array<std::array<std::size_t, D>, R> offsets{};
+            for (std::size_t k = 0; k < R; ++k)
+                for (std::size_t v = 1; v < D; ++v)
+                    offsets[k][v] = offsets[k][v - 1] + numUniqueValuesInSymmetricTensor(D - (v - 1), R - k - 1);
+            return offsets;
+        }
+
+        template<std::size_t D, std::size_t R>
+        inline constexpr auto flatIndexOffsets = flatIndexOffsetTable<D, R>();
+
+    }
+
+    /**
+     * @brief Finds the flat index of an element from the number of times each dimension appears in its index
+     *
+     * @tparam R rank of the tensor
+     * @tparam D size of the tensor
+     *
+     * @param exponents the number of appearances of each dimension, summing to R
+     * @return the corresponding index in a flat array with no redundant values
+     */
+    template<std::size_t R, std::size_t D, typename Count>
+    inline constexpr std::size_t exponentFlatIndex(const std::array<Count, D> &exponents) {
+        constexpr auto &offsets = flatIndexOffsets<D, R>;
+
+        std::size_t flat = 0, position = 0, previous = 0;
+        for (std::size_t d = 0; d < D; ++d) {
+            if (exponents[d] == 0) continue;
+            flat += offsets[position][d] - offsets[position][previous];
+            position += exponents[d];
+            previous = d;
+        }
+        return flat;
+    }
+
+    /**
+     * @brief Converts a multi-dimensional index in a symmetric tensor into a flat index, using a precomputed table
+     *
+     * Produces the same result as @ref flatIndex(), but in \f$ O(R + D) \f$ steps with no sorting or recursion.
+     * The indices are sorted implicitly by counting the appearances of each dimension;
+     * the flat index is then a sum of table entries, one for each distinct dimension present
+     * (this is the combinatorial number system, applied to multisets).
+     *
+     * @tparam D size of the tensor
+     * @tparam R rank of the tensor
+     * @tparam I index type
+     *
+     * @param dimensionalIndices array of R Index types which specifies a value in the tensor, in any order
+     * @return the corresponding index in a flat array with no redundant values
+     */
+    template<std::size_t D, std::size_t R, typename I>
+    inline constexpr std::size_t tabulatedFlatIndex(const std::array<I, R> &dimensionalIndices) {
+        std::array<std::size_t, D> counts{};
+        for (const auto &index: dimensionalIndices)
+            ++counts[static_cast<std::size_t>(index)];
+        return exponentFlatIndex<R>(counts);
+    }
+
+    /**
+     * @brief Converts a sequence of multi-dimensional indices into flat indices
+     *
+     * Batched form of @ref tabulatedFlatIndex(), for streams of runtime indices.
+     *
+     * @tparam D size of the tensor
+     * @tparam R rank of the tensor
+     * @tparam I index type
+     *
+     * @param dimensionalIndices sequence of indices to convert
+     * @param flatIndices output sequence, with the same length as dimensionalIndices
+     */
+    template<std::size_t D, std::size_t R, typename I>
+    inline constexpr void tabulatedFlatIndices(
+            std::span<const std::array<I, R>> dimensionalIndices,
+            std::span<std::size_t> flatIndices
+    ) {
+        assert(dimensionalIndices.size() == flatIndices.size());
+        for (std::size_t i = 0; i < dimensionalIndices.size(); ++i)
+            flatIndices[i] = tabulatedFlatIndex<D>(dimensionalIndices[i]);
+    }
+
+    /**
+     * @brief The canonical index of every unique element of a symmetric tensor, in storage order
+     *
+     * Equivalent to @ref dimensionalIndices() evaluated at every flat index, computed once at compile-time
+     * so that loops over large tensors don't need to reconstruct indices.
+     *
+     * @tparam D size of the tensor
+     * @tparam R rank of the tensor
+     * @tparam I index type
+     */
+    template<std::size_t D, std::size_t R, typename I>
+    inline constexpr auto dimensionalIndexTable = []() consteval {
+        std::array<std::array<I, R>, numUniqueValuesInSymmetricTensor(D, R)> table{};
+        for (std::size_t i = 0; i < table.size(); ++i)
+            table[i] = dimensionalIndices<R, I>(i, D);
+        return table;
+    }();
+
+    /**
+     * @brief The number of times each unique element of a symmetric tensor appears in the full tensor
+     *
+     * Equivalent to @ref num_unique_permutations() of every entry of @ref dimensionalIndexTable.
+     *
+     * @tparam D size of the tensor
+     * @tparam R rank of the tensor
+     * @tparam I index type
+     */
+    template<std::size_t D, std::size_t R, typename I>
+    inline constexpr auto multiplicityTable = []() consteval {
+        std::array<std::size_t, numUniqueValuesInSymmetricTensor(D, R)> table{};
+        for (std::size_t i = 0; i < table.size(); ++i)
+            table[i] = num_unique_permutations(dimensionalIndexTable<D, R, I>[i]);
+        return table;
+    }();
+
+    /**
+     * @brief The number of times each dimension appears in the index of every unique element of a symmetric tensor
+     *
+     * For example, the index (X, X, Z) has exponents (2, 0, 1).
+     *
+     * @tparam D size of the tensor
+     * @tparam R rank of the tensor
+     * @tparam I index type
+     */
+    template<std::size_t D, std::size_t R, typename I>
+    inline constexpr auto exponentTable = []() consteval {
+        std::array<std::array<std::uint8_t, D>, numUniqueValuesInSymmetricTensor(D, R)> table{};
+        for (std::size_t i = 0; i < table.size(); ++i)
+            for (const auto &index: dimensionalIndexTable<D, R, I>[i])
+                ++table[i][static_cast<std::size_t>(index)];
+        return table;
+    }();
+
     namespace {
 
         template<typename I>
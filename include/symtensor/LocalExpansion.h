@@ -0,0 +1,253 @@
+/**
+ * @file
+ * @brief Provides the local (Taylor) expansion type produced by far-field interactions.
+ */
+#ifndef SYMTENSOR_LOCALEXPANSION_H
+#define SYMTENSOR_LOCALEXPANSION_H
+
+#include <symtensor/MultipoleBase.h>
+
+#include <algorithm>
+#include <cassert>
+#include <span>
+
+namespace symtensor {
+
+    namespace {
+
+        // A unique monomial of a vector, the product of a lower-degree monomial (parent) and a single coordinate
+        template<std::size_t D>
+        struct Monomial {
+            std::size_t degree;
+            std::size_t flatIndex;
+            std::size_t parent;
+            std::size_t dimension;
+            // Number of indices which share this monomial, divided by degree!
+            double weight;
+            // Flat index of the product of this monomial with each coordinate, among the monomials one degree higher
+            std::array<std::size_t, D> gradientIndex;
+        };
+
+        // Every unique monomial of a vector up to degree Order, ordered by degree and then by flat index,
+        // so that the parent of each monomial comes before it
+        template<std::size_t D, std::size_t Order, typename I>
+        inline constexpr auto monomialTable = []() consteval {
+            constexpr std::size_t N = []() consteval {
+                std::size_t count = 0;
+                for (std::size_t k = 0; k <= Order; ++k) count += numUniqueValuesInSymmetricTensor(D, k);
+                return count;
+            }();
+            std::array<Monomial<D>, N> table{};
+            table[0] = {0, 0, 0, 0, 1.0, {}};
+            for (std::size_t d = 0; d < D; ++d) table[0].gradientIndex[d] = d;
+
+            std::size_t m = 1, parentOffset = 0;
+            [&]<std::size_t... k>(std::index_sequence<k...>) consteval {
+                ([&]<std::size_t Degree>() consteval {
+                    for (std::size_t j = 0; j < numUniqueValuesInSymmetricTensor(D, Degree); ++j, ++m) {
+                        std::array<std::size_t, D> exponents{};
+                        for (std::size_t d = 0; d < D; ++d) exponents[d] = exponentTable<D, Degree, I>[j][d];
+
+                        auto &monomial = table[m];
+                        monomial.degree = Degree;
+                        monomial.flatIndex = j;
+                        monomial.weight = static_cast<double>(multiplicityTable<D, Degree, I>[j]) /
+                                          static_cast<double>(factorial(Degree));
+                        while (exponents[monomial.dimension] == 0) ++monomial.dimension;
+                        --exponents[monomial.dimension];
+                        if constexpr (Degree > 1) monomial.parent = parentOffset + exponentFlatIndex<Degree - 1>(exponents);
+                        ++exponents[monomial.dimension];
+                        if constexpr (Degree < Order) {
+                            for (std::size_t d = 0; d < D; ++d) {
+                                ++exponents[d];
+                                monomial.gradientIndex[d] = exponentFlatIndex<Degree + 1>(exponents);
+                                --exponents[d];
+                            }
+                        }
+                    }
+                    parentOffset += numUniqueValuesInSymmetricTensor(D, Degree - 1);
+                }.template operator()<k + 1>(), ...);
+            }(std::make_index_sequence<Order>());
+            return table;
+        }();
+
+    }
+
+    /**
+     * @brief Taylor expansion of a field about a point
+     *
+     * The tensor of rank n holds the n-th derivative of the field at the expansion center,
+     * so that the field at a nearby offset x is \f$ \sum_n \frac{1}{n!} L_n \cdot x^{\otimes n} \f$.
+     * For gravity, these are produced from multipole moments by gravity::multipoleToLocal().
+     *
+     * @tparam Order the rank of the highest symmetric tensor
+     * @tparam Tensors prefix of types which make up the lowest ranks of the expansion.
+     *  Must end in a Symmetric tensor -- the final type is "promoted" to produce higher rank tensors
+     *  until the requested Order is reached.
+     */
+    template<std::size_t Order, typename ...Tensors>
+    class LocalExpansion : public MultipoleBaseFromTuple<
+            LocalExpansion<Order, Tensors...>,
+            TensorSequence<Order, typename last_type<Tensors...>::Scalar, Tensors...>
+    > {
+
+        using Base = MultipoleBaseFromTuple<
+                LocalExpansion<Order, Tensors...>,
+                TensorSequence<Order, typename last_type<Tensors...>::Scalar, Tensors...>
+        >;
+
+        using Scalar = typename last_type<Tensors...>::Scalar;
+
+        static constexpr std::size_t Dimensions = last_type<Tensors...>::Dimensions;
+
+        // Particles are evaluated in blocks, with one lane of each array per particle.
+        // Smaller blocks tend to be unrolled into scalar code rather than vectorized.
+        static constexpr std::size_t BlockSize = 32;
+
+    public:
+
+        using Base::Base;
+
+        /**
+         * @brief Local-to-local (L2L) translation
+         *
+         * Produces the expansion of the same field about a center moved by offset,
+         * \f[ L'_n = \sum_{k=0}^{Q - n} \frac{1}{k!} L_{n + k} \cdot d^{\otimes k} \f]
+         * where each contraction with the offset is done by SymmetricTensorBase::contract().
+         * Because the expansion is a polynomial, this is exact: no further truncation is introduced.
+         *
+         * @param offset the displacement of the new expansion center from the current one
+         * @return the translated local expansion
+         */
+        template<indexable Vector>
+        inline constexpr LocalExpansion translated(const Vector &offset) const {
+            LocalExpansion result{};
+            [&]<std::size_t... n>(std::index_sequence<n...>) LAMBDA_ALWAYS_INLINE {
+                ((result.template tensor<n>() = translatedTensor<n>(offset)), ...);
+            }(std::make_index_sequence<Base::NumTensors>());
+            return result;
+        }
+
+        /**
+         * @brief Batched local-to-particle (L2P) evaluation
+         *
+         * Accumulates the value of the expansion, \f$ \sum_n \frac{1}{n!} L_n \cdot x^{\otimes n} \f$,
+         * and its gradient at every position, where x is the position relative to the expansion center.
+         * For gravity (see gravity::multipoleToLocal()), these are the negated potential and the acceleration.
+         *
+         * The expansion is first flattened into a single coefficient for each unique monomial of x.
+         * Particles are then processed in blocks, one lane per particle:
+         * each monomial is the product of a lower-degree monomial and one coordinate,
+         * so the powers of the displacement are shared across orders,
+         * and every step is a loop across the particles of a block which the compiler can vectorize.
+         *
+         * @param center the expansion center
+         * @param positions the locations at which to evaluate the expansion
+         * @param gradients the gradient at each position is added to the corresponding vector
+         * @param values the value at each position is added to the corresponding scalar
+         */
+        template<indexable Vector, indexable Position, indexable Gradient>
+        inline void evaluate(const Vector &center, std::span<const Position> positions,
+                             std::span<Gradient> gradients, std::span<Scalar> values) const {
+            assert(positions.size() == gradients.size() && positions.size() == values.size());
+            constexpr auto &table = monomialTable<Dimensions, Order, typename Base::Index>;
+            constexpr std::size_t NumMonomials = table.size();
+            constexpr std::size_t NumGradientMonomials =
+                    NumMonomials - numUniqueValuesInSymmetricTensor(Dimensions, Order);
+
+            // Coefficients of each monomial in the value and in each component of the gradient
+            std::array<Scalar, NumMonomials> valueCoefficients{};
+            std::array<std::array<Scalar, NumGradientMonomials>, Dimensions> gradientCoefficients{};
+            [&]<std::size_t... n>(std::index_sequence<n...>) LAMBDA_ALWAYS_INLINE {
+                (fillCoefficients<n>(valueCoefficients, gradientCoefficients), ...);
+            }(std::make_index_sequence<Base::NumTensors>());
+
+            for (std::size_t start = 0; start < positions.size(); start += BlockSize) {
+                const std::size_t count = std::min(BlockSize, positions.size() - start);
+
+                // Unused lanes of the final block are left at the origin
+                std::array<std::array<Scalar, BlockSize>, Dimensions> coordinates{};
+                for (std::size_t l = 0; l < count; ++l)
+                    for (std::size_t d = 0; d < Dimensions; ++d)
+                        coordinates[d][l] = positions[start + l][d] - center[d];
+
+                std::array<std::array<Scalar, BlockSize>, NumMonomials> monomials;
+                std::array<Scalar, BlockSize> value{};
+                std::array<std::array<Scalar, BlockSize>, Dimensions> gradient{};
+                monomials[0].fill(Scalar{1});
+                [&]<std::size_t... m>(std::index_sequence<m...>) LAMBDA_ALWAYS_INLINE {
+                    ([&]() LAMBDA_ALWAYS_INLINE {
+                        if constexpr (m > 0) {
+                            constexpr std::size_t parent = table[m].parent, dimension = table[m].dimension;
+                            for (std::size_t l = 0; l < BlockSize; ++l)
+                                monomials[m][l] = monomials[parent][l] * coordinates[dimension][l];
+                        }
+                        for (std::size_t l = 0; l < BlockSize; ++l)
+                            value[l] += valueCoefficients[m] * monomials[m][l];
+                        if constexpr (m < NumGradientMonomials) {
+                            for (std::size_t d = 0; d < Dimensions; ++d)
+                                for (std::size_t l = 0; l < BlockSize; ++l)
+                                    gradient[d][l] += gradientCoefficients[d][m] * monomials[m][l];
+                        }
+                    }(), ...);
+                }(std::make_index_sequence<NumMonomials>());
+
+                for (std::size_t l = 0; l < count; ++l) {
+                    values[start + l] += value[l];
+                    for (std::size_t d = 0; d < Dimensions; ++d)
+                        gradients[start + l][d] += gradient[d][l];
+                }
+            }
+        }
+
+        inline constexpr const Scalar &scalar() const { return this->template tensor<0>(); }
+
+        inline constexpr Scalar &scalar() { return this->template tensor<0>(); }
+
+    private:
+
+        // The rank-N tensor of the expansion about a center moved by offset
+        template<std::size_t N, typename Vector>
+        ALWAYS_INLINE constexpr auto translatedTensor(const Vector &offset) const {
+            auto tensor = this->template tensor<N>();
+            [&]<std::size_t... k>(std::index_sequence<k...>) LAMBDA_ALWAYS_INLINE {
+                ((tensor += this->template tensor<N + k + 1>().template contract<k + 1>(offset) *
+                            scalar_cast<Scalar>(1.0 / static_cast<double>(factorial(k + 1)))), ...);
+            }(std::make_index_sequence<Order - N>());
+            return tensor;
+        }
+
+        // Adds the rank-N tensor to the coefficients of the monomials of degree N (in the value)
+        // and of degree N - 1 (in the gradient)
+        template<std::size_t N, typename ValueCoefficients, typename GradientCoefficients>
+        inline void fillCoefficients(ValueCoefficients &valueCoefficients,
+                                     GradientCoefficients &gradientCoefficients) const {
+            constexpr auto &table = monomialTable<Dimensions, Order, typename Base::Index>;
+            const auto &tensor = this->template tensor<N>();
+            for (std::size_t m = 0; m < table.size(); ++m) {
+                if (table[m].degree == N) {
+                    if constexpr (N == 0)
+                        valueCoefficients[m] = tensor;
+                    else
+                        valueCoefficients[m] = tensor[table[m].flatIndex] * scalar_cast<Scalar>(table[m].weight);
+                }
+                if constexpr (N > 0) {
+                    if (table[m].degree == N - 1)
+                        for (std::size_t d = 0; d < Dimensions; ++d)
+                            gradientCoefficients[d][m] = tensor[table[m].gradientIndex[d]] *
+                                                         scalar_cast<Scalar>(table[m].weight);
+                }
+            }
+        }
+
+    };
+
+    template<std::size_t Order>
+    using LocalExpansion2f = LocalExpansion<Order, SymmetricTensor2f<1>>;
+
+    template<std::size_t Order>
+    using LocalExpansion3f = LocalExpansion<Order, SymmetricTensor3f<1>>;
+
+}
+
+#endif //SYMTENSOR_LOCALEXPANSION_H
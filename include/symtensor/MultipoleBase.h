@@ -6,6 +6,7 @@
 #define SYMTENSOR_MULTIPOLEBASE_H
 
 #include <symtensor/SymmetricTensor.h>
+#include <symtensor/MultipoleExpression.h>
 #include <symtensor/Index.h>
 #include <symtensor/concepts.h>
 #include <symtensor/util.h>
@@ -245,7 +246,7 @@ namespace symtensor {
          * @param scalar value to add to each tensor of the multipole
          * @return the modified multipole
          */
-        template<typename T>
+        template<typename T> requires (!multipole_operand<T>)
         inline constexpr Implementation &operator+=(const T &scalar) {
             std::apply([&](Tensors &... tupleElements) {
                 ((tupleElements += scalar), ...);
@@ -259,7 +260,7 @@ namespace symtensor {
          * @param scalar value to subtract from each tensor of the multipole
          * @return the modified multipole
          */
-        template<typename T>
+        template<typename T> requires (!multipole_operand<T>)
         inline constexpr Implementation &operator-=(const T &scalar) {
             std::apply([&](Tensors &... tupleElements) {
                 ((tupleElements -= scalar), ...);
@@ -273,7 +274,7 @@ namespace symtensor {
          * @param scalar value to multiply each tensor of the multipole by.
          * @return the modified multipole
          */
-        template<typename T>
+        template<typename T> requires (!multipole_operand<T>)
         inline constexpr Implementation &operator*=(const T &scalar) {
             std::apply([&](Tensors &... tupleElements) {
                 ((tupleElements *= scalar), ...);
@@ -287,7 +288,7 @@ namespace symtensor {
          * @param scalar value to divide each element of the multipole by.
          * @return the modified multipole
          */
-        template<typename T>
+        template<typename T> requires (!multipole_operand<T>)
         inline constexpr Implementation &operator/=(const T &scalar) {
             std::apply([&](Tensors &... tupleElements) {
                 ((tupleElements /= scalar), ...);
@@ -296,25 +297,21 @@ namespace symtensor {
         }
 
         /// @copydoc operator+=(const T &)
-        template<typename T>
+        template<typename T> requires (!multipole_operand<T>)
         inline constexpr Implementation operator+(const T &scalar) const {
             return Implementation{implementation()} += scalar;
         }
 
         /// @copydoc operator-=(const T &)
-        template<typename T>
+        template<typename T> requires (!multipole_operand<T>)
         inline constexpr Implementation operator-(const T &scalar) const {
             return Implementation{implementation()} -= scalar;
         }
 
-        /// @copydoc operator*=(const T &)
-        template<typename T>
-        inline constexpr Implementation operator*(const T &scalar) const {
-            return Implementation{implementation()} *= scalar;
-        }
+        // Multiplication by a scalar produces a lazy MultipoleExpression, see MultipoleExpression.h
 
         /// @copydoc operator/=(const T &)
-        template<typename T>
+        template<typename T> requires (!multipole_operand<T>)
         inline constexpr Implementation operator/(const T &scalar) const {
             return Implementation{implementation()} /= scalar;
         }
@@ -376,15 +373,7 @@ namespace symtensor {
             return *static_cast<Implementation *>(this);
         }
 
-        /// @copydoc operator+=(const Implementation &)
-        inline constexpr Implementation operator+(const Implementation &other) const {
-            return Implementation{implementation()} += other;
-        }
-
-        /// @copydoc operator-=(const Implementation &)
-        inline constexpr Implementation operator-(const Implementation &other) const {
-            return Implementation{implementation()} -= other;
-        }
+        // Addition and subtraction of multipoles produce a lazy MultipoleExpression, see MultipoleExpression.h
 
         /// @copydoc operator*=(const Implementation &)
         inline constexpr Implementation operator*(const Implementation &other) const {
@@ -404,17 +393,23 @@ namespace symtensor {
         /**
          * @brief Comparison with another multipole
          *
+         * A scalar component with a vector scalar type is only equivalent if every lane is equal.
+         *
          * @param other multipole to compare with
          * @return true if all elements of the multipoles are equivalent, false otherwise
          */
-        inline constexpr bool operator==(const Self &other) const = default;
+        inline constexpr bool operator==(const Self &other) const {
+            return [&]<std::size_t... i>(std::index_sequence<i...>) {
+                return (all_lanes(std::get<i>(_tuple) == std::get<i>(other._tuple)) && ...);
+            }(std::make_index_sequence<NumTensors>());
+        }
 
         /// @}
     public:
 
         friend std::ostream &operator<<(std::ostream &out, const Self &self) {
             std::apply([&](const Tensors &... tupleElements) {
-                ((out << tupleElements << " "), ...);
+                ((print_scalar(out, tupleElements) << " "), ...);
             }, self._tuple);
             return out;
         }
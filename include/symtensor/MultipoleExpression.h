@@ -0,0 +1,246 @@
+/**
+ * @file
+ * @brief Provides lazily-evaluated element-wise expressions of multipoles.
+ */
+#ifndef SYMTENSOR_MULTIPOLEEXPRESSION_H
+#define SYMTENSOR_MULTIPOLEEXPRESSION_H
+
+#include "platform.h"
+#include "util.h"
+#include "TensorExpression.h"
+
+#include <functional>
+#include <tuple>
+#include <utility>
+
+namespace symtensor {
+
+    template<class Implementation, typename ...Tensors>
+    class MultipoleBase;
+
+    template<typename Operation, typename... Operands>
+    class MultipoleExpression;
+
+    namespace {
+
+        template<class Implementation, typename ...Tensors>
+        Implementation multipole_implementation_of(const MultipoleBase<Implementation, Tensors...> &);
+
+        template<typename T>
+        struct is_multipole_expression : std::false_type {
+        };
+        template<typename Operation, typename... Operands>
+        struct is_multipole_expression<MultipoleExpression<Operation, Operands...>> : std::true_type {
+        };
+
+    }
+
+    /**
+     * @brief Any type derived from MultipoleBase.
+     */
+    template<typename T>
+    concept multipole_type = requires(const std::remove_cvref_t<T> &t) { multipole_implementation_of(t); };
+
+    /**
+     * @brief A lazy element-wise expression of multipoles, see @ref MultipoleExpression.
+     */
+    template<typename T>
+    concept multipole_expression = is_multipole_expression<std::remove_cvref_t<T>>::value;
+
+    /**
+     * @brief Anything which can appear as the operand of a lazy multipole expression.
+     */
+    template<typename T>
+    concept multipole_operand = multipole_type<T> || multipole_expression<T>;
+
+    namespace {
+
+        template<typename... Operands>
+        struct first_multipole_operand {
+        };
+        template<typename First, typename... Rest>
+        struct first_multipole_operand<First, Rest...> {
+            using type = typename std::conditional_t<
+                    multipole_operand<First>,
+                    std::type_identity<First>,
+                    first_multipole_operand<Rest...>
+            >::type;
+        };
+
+        template<typename T>
+        struct expression_multipole_helper {
+            using type = decltype(multipole_implementation_of(std::declval<const T &>()));
+        };
+        template<multipole_expression T>
+        struct expression_multipole_helper<T> {
+            using type = typename T::Multipole;
+        };
+
+    }
+
+    /**
+     * @brief The concrete multipole type produced by evaluating a multipole operand.
+     */
+    template<multipole_operand T>
+    using expression_multipole = typename expression_multipole_helper<std::remove_cvref_t<T>>::type;
+
+    /**
+     * @brief How an operand is held by a multipole expression.
+     *
+     * Multipoles passed as lvalues are held by reference, temporaries and expressions are held by value.
+     */
+    template<typename T>
+    using multipole_expression_operand = std::conditional_t<
+            std::is_lvalue_reference_v<T> && multipole_type<T>,
+            const std::remove_cvref_t<T> &,
+            std::remove_cvref_t<T>
+    >;
+
+    /**
+     * @brief Lazily evaluated element-wise operation on multipoles and scalars.
+     *
+     * Each tensor of the result is itself a lazy @ref TensorExpression,
+     * so a chain of operations is evaluated in a single pass over each tensor once assigned to a multipole.
+     *
+     * @warning An expression may refer to the multipoles it was built from,
+     *  evaluate it (see eval()) before those multipoles go out of scope.
+     *
+     * @tparam Operation element-wise function object, e.g. std::plus<>
+     * @tparam Operands multipoles, expressions, or scalars (which are broadcast to every tensor)
+     */
+    template<typename Operation, typename... Operands>
+    class MultipoleExpression {
+    public:
+
+        using Multipole = expression_multipole<typename first_multipole_operand<Operands...>::type>;
+
+        static constexpr std::size_t NumTensors = Multipole::NumTensors;
+
+    private:
+
+        std::tuple<Operands...> _operands;
+
+        template<std::size_t I, typename Operand>
+        ALWAYS_INLINE static constexpr decltype(auto) component(const Operand &operand) {
+            if constexpr (multipole_operand<Operand>)
+                return operand.template get<I>();
+            else
+                return operand;
+        }
+
+    public:
+        /// @name Constructors
+        /// @{
+
+        template<typename... Args>
+        requires (sizeof...(Args) == sizeof...(Operands) && sizeof...(Args) > 1)
+        ALWAYS_INLINE explicit constexpr MultipoleExpression(Args &&...operands) :
+                _operands(std::forward<Args>(operands)...) {}
+
+        /// @}
+    public:
+        /// @name Evaluation
+        /// @{
+
+        /**
+         * @brief Lazy access to a single tensor of the expression
+         *
+         * @tparam I index of the tensor (not necessarily the same as its rank)
+         * @return an expression (or scalar) which produces that tensor
+         */
+        template<std::size_t I>
+        ALWAYS_INLINE constexpr auto get() const {
+            return std::apply([&](const Operands &... operands) LAMBDA_ALWAYS_INLINE {
+                return Operation{}(component<I>(operands)...);
+            }, _operands);
+        }
+
+        /**
+         * @brief Evaluates the expression
+         *
+         * @return a multipole containing the result of the expression.
+         */
+        ALWAYS_INLINE constexpr Multipole eval() const {
+            return [&]<std::size_t... i>(std::index_sequence<i...>) LAMBDA_ALWAYS_INLINE {
+                return Multipole{std::tuple_element_t<i, typename Multipole::TensorTuple>(get<i>())...};
+            }(std::make_index_sequence<NumTensors>());
+        }
+
+        /// @copydoc eval()
+        ALWAYS_INLINE constexpr operator Multipole() const { return eval(); }
+
+        /// @}
+    public:
+
+        inline friend constexpr bool operator==(const MultipoleExpression &expression, const Multipole &multipole) {
+            return expression.eval() == multipole;
+        }
+
+        friend std::ostream &operator<<(std::ostream &out, const MultipoleExpression &expression) {
+            return out << expression.eval();
+        }
+
+    };
+
+    /// @name Lazy multipole arithmetic
+    /// @{
+
+    /**
+     * @brief Lazy element-wise addition of two multipoles
+     */
+    template<multipole_operand L, multipole_operand R>
+    requires std::same_as<expression_multipole<L>, expression_multipole<R>>
+    ALWAYS_INLINE constexpr auto operator+(L &&lhs, R &&rhs) {
+        return MultipoleExpression<std::plus<>, multipole_expression_operand<L>, multipole_expression_operand<R>>{
+                std::forward<L>(lhs), std::forward<R>(rhs)
+        };
+    }
+
+    /**
+     * @brief Lazy element-wise subtraction of two multipoles
+     */
+    template<multipole_operand L, multipole_operand R>
+    requires std::same_as<expression_multipole<L>, expression_multipole<R>>
+    ALWAYS_INLINE constexpr auto operator-(L &&lhs, R &&rhs) {
+        return MultipoleExpression<std::minus<>, multipole_expression_operand<L>, multipole_expression_operand<R>>{
+                std::forward<L>(lhs), std::forward<R>(rhs)
+        };
+    }
+
+    /**
+     * @brief Lazy multiplication of every tensor of a multipole by a scalar
+     */
+    template<multipole_operand L, typename S>
+    requires (!multipole_operand<S> && !tensor_operand<S>)
+    ALWAYS_INLINE constexpr auto operator*(L &&lhs, const S &scalar) {
+        return MultipoleExpression<std::multiplies<>, multipole_expression_operand<L>, S>{
+                std::forward<L>(lhs), scalar
+        };
+    }
+
+    /// @copydoc operator*(L &&, const S &)
+    template<typename S, multipole_operand R>
+    requires (!multipole_operand<S> && !tensor_operand<S>)
+    ALWAYS_INLINE constexpr auto operator*(const S &scalar, R &&rhs) {
+        return MultipoleExpression<std::multiplies<>, S, multipole_expression_operand<R>>{
+                scalar, std::forward<R>(rhs)
+        };
+    }
+
+    /**
+     * @brief Division of a multipole expression by a scalar
+     *
+     * Multipole types may redefine division (MultipoleMoment only normalizes its first-order tensor),
+     * so the expression is evaluated and then divided using the operator of the resulting type.
+     */
+    template<multipole_expression L, typename S>
+    requires (!multipole_operand<S> && !tensor_operand<S>)
+    inline constexpr auto operator/(const L &lhs, const S &scalar) {
+        return lhs.eval() / scalar;
+    }
+
+    /// @}
+
+}
+
+#endif //SYMTENSOR_MULTIPOLEEXPRESSION_H
@@ -9,6 +9,22 @@
 
 namespace symtensor {
 
+    namespace {
+
+        // Terms which carry the rank-K tensor of a multipole moment into the rank-N tensor of its translation.
+        // These are the terms of the symmetric outer product of the rank-K tensor with the (N - K)-th power of the offset,
+        // scaled by the binomial coefficient (N choose K).
+        template<std::size_t D, std::size_t N, std::size_t K, typename I>
+        inline constexpr auto translationTable = []() consteval {
+            auto table = outerProductTable<D, K, N - K, I>;
+            const double binomial = static_cast<double>(factorial(N)) /
+                                    static_cast<double>(factorial(K) * factorial(N - K));
+            for (auto &term: table.terms) term.weight *= binomial;
+            return table;
+        }();
+
+    }
+
     /**
      * @brief Generic multipole type
      *
@@ -46,22 +62,69 @@ namespace symtensor {
             }(std::make_index_sequence<Self::NumTensors - 1>());
         }
 
+        /**
+         * @brief Produces the traceless multipole of a unit mass at a position
+         *
+         * Each tensor of rank n is \f$ (2n - 1)!! \f$ times the traceless part of the n-th power of the position
+         * (see SymmetricTensorBase::detrace()),
+         * so the quadrupole is \f$ 3 r_i r_j - |r|^2 \delta_{ij} \f$.
+         * In three dimensions, these are the tensors which appear in the derivatives of \f$ 1 / |r| \f$.
+         *
+         * @param position the location of the mass, relative to the expansion center
+         * @return the multipole of that mass, with every tensor traceless
+         */
         template<indexable Vector>
-        static inline constexpr MultipoleMoment TracelessFromPosition(const Vector &position, float magnitude) {
+        static inline constexpr MultipoleMoment TracelessFromPosition(const Vector &position) {
             return [&]<std::size_t... i>(std::index_sequence<i...>) constexpr {
                 return Self{
                         Scalar{1},
                         (
-                                std::tuple_element_t<i + 1, typename Self::TensorTuple>::CartesianPower(position) * 3
-                                - (
-                                        std::tuple_element_t<i + 1, typename Self::TensorTuple>::Identity()
-                                        * magnitude
+                                std::tuple_element_t<i + 1, typename Self::TensorTuple>::CartesianPower(position).detrace()
+                                * scalar_cast<typename std::tuple_element_t<i + 1, typename Self::TensorTuple>::Scalar>(
+                                        double_factorial(2 * i + 1)
                                 )
                         )...
                 };
             }(std::make_index_sequence<Self::NumTensors - 1>());
         }
 
+        /**
+         * @brief Produces the multipole moment of the same masses, each displaced by an offset
+         *
+         * Equivalently, this is the moment about an expansion center moved by -offset,
+         * so a child node's moment is carried to its parent's center by
+         * `child.translated(childCenter - parentCenter)`.
+         * Each tensor is found by the binomial expansion of \f$ (x + d)^{\otimes n} \f$:
+         * \f[ M'_n = \sum_{k=0}^{n} \binom{n}{k} M_k \odot d^{\otimes (n - k)} \f]
+         * where the terms of each symmetric outer product, with their coefficients, are found at compile-time.
+         *
+         * @param offset the displacement to apply, as a vector
+         * @return the translated multipole moment
+         */
+        template<indexable Vector>
+        inline constexpr MultipoleMoment translated(const Vector &offset) const {
+            return MultipoleMoment{}.addTranslated(*this, offset);
+        }
+
+        /**
+         * @brief Accumulates the translation of another multipole moment
+         *
+         * Equivalent to `*this += other.translated(offset)`, without producing an intermediate multipole.
+         * This is the multipole-to-multipole (M2M) step used to build a parent node's moment from its children.
+         *
+         * @param other the multipole moment to translate
+         * @param offset the displacement to apply to other, see translated()
+         * @return the modified multipole
+         */
+        template<indexable Vector>
+        inline constexpr MultipoleMoment &addTranslated(const MultipoleMoment &other, const Vector &offset) {
+            const auto powers = FromPosition(offset);
+            [&]<std::size_t... n>(std::index_sequence<n...>) LAMBDA_ALWAYS_INLINE {
+                (addTranslatedTensor<n>(other, powers), ...);
+            }(std::make_index_sequence<Self::NumTensors>());
+            return *this;
+        }
+
         inline constexpr const Scalar &scalar() const { return this->template tensor<0>(); }
 
         inline constexpr Scalar &scalar() { return this->template tensor<0>(); }
@@ -72,6 +135,44 @@ namespace symtensor {
             return *this;
         }
 
+    private:
+
+        // Adds the rank-N tensor of other, translated using powers of the offset
+        template<std::size_t N>
+        ALWAYS_INLINE constexpr void addTranslatedTensor(const MultipoleMoment &other, const MultipoleMoment &powers) {
+            auto &result = this->template tensor<N>();
+            result += other.template tensor<N>();
+            if constexpr (N > 0) {
+                result += powers.template tensor<N>() * other.scalar();
+                [&]<std::size_t... k>(std::index_sequence<k...>) LAMBDA_ALWAYS_INLINE {
+                    (addTranslationTerms<N, k + 1>(
+                            result, other.template tensor<k + 1>(), powers.template tensor<N - k - 1>()
+                    ), ...);
+                }(std::make_index_sequence<N - 1>());
+            }
+        }
+
+        // Adds binomial(N, K) * (tensor ⊙ power) to result, where tensor has rank K and power has rank N - K
+        template<std::size_t N, std::size_t K, typename Result, typename Tensor, typename Power>
+        ALWAYS_INLINE static constexpr void addTranslationTerms(Result &result, const Tensor &tensor, const Power &power) {
+            using TensorScalar = typename Result::Scalar;
+            constexpr auto &table = translationTable<Result::Dimensions, N, K, typename Result::Index>;
+            if constexpr (table.terms.size() > SYMTENSOR_UNROLL_THRESHOLD) {
+                for (std::size_t i = 0; i < Result::NumUniqueValues; ++i)
+                    for (std::size_t t = table.offsets[i]; t < table.offsets[i + 1]; ++t)
+                        result[i] += scalar_cast<TensorScalar>(table.terms[t].weight) *
+                                     tensor[table.terms[t].lhsIndex] * power[table.terms[t].rhsIndex];
+            } else {
+                [&]<std::size_t... i>(std::index_sequence<i...>) LAMBDA_ALWAYS_INLINE {
+                    ((result[i] += [&]<std::size_t... t>(std::index_sequence<t...>) LAMBDA_ALWAYS_INLINE {
+                        constexpr std::size_t first = table.offsets[i];
+                        return ((scalar_cast<TensorScalar>(table.terms[first + t].weight) *
+                                 tensor[table.terms[first + t].lhsIndex] * power[table.terms[first + t].rhsIndex]) + ...);
+                    }(std::make_index_sequence<table.offsets[i + 1] - table.offsets[i]>())), ...);
+                }(std::make_index_sequence<Result::NumUniqueValues>());
+            }
+        }
+
     };
 
     template<std::size_t Order>
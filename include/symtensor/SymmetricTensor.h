@@ -22,6 +22,7 @@ namespace symtensor {
         using Base = SymmetricTensorBase<SymmetricTensor<S, D, R, I>, S, D, R, I>;
     public:
         using Base::Base;
+        using Base::operator=;
     };
 
     template<std::size_t R>
@@ -0,0 +1,421 @@
+/**
+ * @file
+ * @brief Provides a structure-of-arrays container for large batches of symmetric tensors.
+ */
+#ifndef SYMTENSOR_SYMMETRICTENSORARRAY_H
+#define SYMTENSOR_SYMMETRICTENSORARRAY_H
+
+#include <symtensor/SymmetricTensor.h>
+
+#include <array>
+#include <cassert>
+#include <vector>
+#include <span>
+
+namespace symtensor {
+
+    /**
+     * @brief Container for a large number of symmetric tensors, stored as a structure of arrays
+     *
+     * Rather than storing each tensor contiguously (as in `std::vector<SymmetricTensor<S, D, R>>`),
+     * element `i` of every tensor is stored in its own contiguous array.
+     * Bulk operations then become long loops over a single component,
+     * which vectorize much better than many short loops over the elements of individual tensors.
+     *
+     * Components are laid out according to the same flat index used by @ref SymmetricTensorBase,
+     * so @code{.cpp} array.at<X, Y, Z>(n) @endcode resolves its component at compile-time.
+     *
+     * @tparam S scalar type
+     * @tparam D number of dimensions (2d, 3d, etc.)
+     * @tparam R rank
+     * @tparam I index type, defaults to the appropriate @ref Index
+     */
+    template<typename S, std::size_t D, std::size_t R, typename I = Index<D>>
+    class SymmetricTensorArray {
+    public:
+
+        using Tensor = SymmetricTensor<S, D, R, I>;
+
+        using Scalar = S;
+        static constexpr std::size_t Dimensions = D;
+        static constexpr std::size_t Rank = R;
+        static constexpr std::size_t NumUniqueValues = Tensor::NumUniqueValues;
+
+        using Index = I;
+
+    private:
+
+        std::array<std::vector<S>, NumUniqueValues> _components{};
+
+    public:
+        /// @name Constructors
+        /// @{
+
+        /**
+         * @brief Default constructor.
+         *
+         * Produces an empty array.
+         */
+        explicit SymmetricTensorArray() = default;
+
+        /**
+         * @brief Constructor with a fixed size.
+         *
+         * @param size number of tensors in the array, all initialized to 0.
+         */
+        explicit SymmetricTensorArray(std::size_t size) {
+            resize(size);
+        }
+
+        /**
+         * @brief Constructor from a sequence of tensors.
+         *
+         * @param tensors tensors to scatter into the new array.
+         */
+        explicit SymmetricTensorArray(std::span<const Tensor> tensors) : SymmetricTensorArray(tensors.size()) {
+            for (std::size_t n = 0; n < tensors.size(); ++n)
+                set(n, tensors[n]);
+        }
+
+        /// @}
+    public:
+        /// @name Size
+        /// @{
+
+        /**
+         * @brief The number of tensors in the array
+         */
+        [[nodiscard]] inline std::size_t size() const { return _components[0].size(); }
+
+        /**
+         * @brief Checks whether the array contains any tensors
+         */
+        [[nodiscard]] inline bool empty() const { return _components[0].empty(); }
+
+        /**
+         * @brief Changes the number of tensors in the array
+         *
+         * @param size the new number of tensors, new tensors are initialized to 0.
+         */
+        inline void resize(std::size_t size) {
+            for (auto &component: _components)
+                component.resize(size, S{0});
+        }
+
+        /**
+         * @brief Reserves storage for a number of tensors, without changing the size of the array
+         *
+         * @param capacity number of tensors to reserve space for.
+         */
+        inline void reserve(std::size_t capacity) {
+            for (auto &component: _components)
+                component.reserve(capacity);
+        }
+
+        /**
+         * @brief Appends a tensor to the end of the array
+         *
+         * @param tensor the tensor to scatter into the new position.
+         */
+        inline void push_back(const Tensor &tensor) {
+            for (std::size_t i = 0; i < NumUniqueValues; ++i)
+                _components[i].push_back(tensor[i]);
+        }
+
+        /// @}
+    public:
+        /// @name Member access
+        /// @{
+
+        /**
+         * @brief Gathers a single tensor from the array
+         *
+         * @param n position of the tensor in the array
+         * @return a copy of the tensor at position n
+         */
+        inline Tensor get(std::size_t n) const {
+            assert(n < size());
+            Tensor tensor{};
+            for (std::size_t i = 0; i < NumUniqueValues; ++i)
+                tensor[i] = _components[i][n];
+            return tensor;
+        }
+
+        /// @copydoc get()
+        inline Tensor operator[](std::size_t n) const { return get(n); }
+
+        /**
+         * @brief Scatters a single tensor into the array
+         *
+         * @param n position of the tensor in the array
+         * @param tensor the new value of the tensor at position n
+         */
+        inline void set(std::size_t n, const Tensor &tensor) {
+            assert(n < size());
+            for (std::size_t i = 0; i < NumUniqueValues; ++i)
+                _components[i][n] = tensor[i];
+        }
+
+        /**
+         * @brief Compile-time indexed member access
+         *
+         * Equivalent to @code{.cpp} array.get(n).at<Indices...>() @endcode,
+         * without gathering the rest of the tensor.
+         *
+         * @tparam Indices Sequence of R Index values which specify an element of the tensor.
+         * @param n position of the tensor in the array
+         * @return the scalar element at the requested index of the tensor at position n
+         */
+        template<Index... Indices>
+        inline const Scalar &at(std::size_t n) const {
+            return component<Indices...>()[n];
+        }
+
+        /// @copydoc at(std::size_t) const
+        template<Index... Indices>
+        inline Scalar &at(std::size_t n) {
+            return component<Indices...>()[n];
+        }
+
+        /**
+         * @brief Direct access to the contiguous storage of a single element
+         *
+         * @param flatIndex flat index of the element, as used by @ref SymmetricTensorBase::flat()
+         * @return a span over the requested element of every tensor in the array
+         */
+        inline std::span<const Scalar> component(std::size_t flatIndex) const {
+            return {_components[flatIndex].data(), size()};
+        }
+
+        /// @copydoc component(std::size_t) const
+        inline std::span<Scalar> component(std::size_t flatIndex) {
+            return {_components[flatIndex].data(), size()};
+        }
+
+        /**
+         * @brief Compile-time indexed access to the contiguous storage of a single element
+         *
+         * @tparam Indices Sequence of R Index values which specify an element of the tensor.
+         * @return a span over the requested element of every tensor in the array
+         */
+        template<Index... Indices>
+        inline std::span<const Scalar> component() const {
+            return component(Tensor::template flatIndex<std::array<I, R>{static_cast<Index>(Indices)...}>());
+        }
+
+        /// @copydoc component() const
+        template<Index... Indices>
+        inline std::span<Scalar> component() {
+            return component(Tensor::template flatIndex<std::array<I, R>{static_cast<Index>(Indices)...}>());
+        }
+
+        /// @}
+    public:
+        /// @name Bulk tensor-scalar operators
+        /// @{
+
+        /**
+         * @brief Element-wise addition of a scalar to every tensor
+         *
+         * @param scalar value to add to each element of each tensor
+         * @return the modified array
+         */
+        inline SymmetricTensorArray &operator+=(const Scalar &scalar) {
+            return apply([&](Scalar &v) { v += scalar; });
+        }
+
+        /**
+         * @brief Element-wise subtraction of a scalar from every tensor
+         *
+         * @param scalar value to subtract from each element of each tensor
+         * @return the modified array
+         */
+        inline SymmetricTensorArray &operator-=(const Scalar &scalar) {
+            return apply([&](Scalar &v) { v -= scalar; });
+        }
+
+        /**
+         * @brief Multiplication of every tensor by a scalar
+         *
+         * @param scalar value to multiply each element of each tensor by
+         * @return the modified array
+         */
+        inline SymmetricTensorArray &operator*=(const Scalar &scalar) {
+            return apply([&](Scalar &v) { v *= scalar; });
+        }
+
+        /**
+         * @brief Division of every tensor by a scalar
+         *
+         * @param scalar value to divide each element of each tensor by
+         * @return the modified array
+         */
+        inline SymmetricTensorArray &operator/=(const Scalar &scalar) {
+            return apply([&](Scalar &v) { v /= scalar; });
+        }
+
+        /// @}
+    public:
+        /// @name Bulk tensor-tensor operators
+        /// @{
+
+        /**
+         * @brief Element-wise addition of a single tensor to every tensor in the array
+         *
+         * @param tensor tensor to add to each tensor
+         * @return the modified array
+         */
+        inline SymmetricTensorArray &operator+=(const Tensor &tensor) {
+            for (std::size_t i = 0; i < NumUniqueValues; ++i)
+                for (auto &v: _components[i]) v += tensor[i];
+            return *this;
+        }
+
+        /**
+         * @brief Element-wise subtraction of a single tensor from every tensor in the array
+         *
+         * @param tensor tensor to subtract from each tensor
+         * @return the modified array
+         */
+        inline SymmetricTensorArray &operator-=(const Tensor &tensor) {
+            for (std::size_t i = 0; i < NumUniqueValues; ++i)
+                for (auto &v: _components[i]) v -= tensor[i];
+            return *this;
+        }
+
+        /**
+         * @brief Element-wise addition with another array of the same size
+         *
+         * @param other array whose tensors are added to the corresponding tensors of this array
+         * @return the modified array
+         */
+        inline SymmetricTensorArray &operator+=(const SymmetricTensorArray &other) {
+            return apply(other, [](Scalar &v, const Scalar &o) { v += o; });
+        }
+
+        /**
+         * @brief Element-wise subtraction by another array of the same size
+         *
+         * @param other array whose tensors are subtracted from the corresponding tensors of this array
+         * @return the modified array
+         */
+        inline SymmetricTensorArray &operator-=(const SymmetricTensorArray &other) {
+            return apply(other, [](Scalar &v, const Scalar &o) { v -= o; });
+        }
+
+        /**
+         * @brief Scales each tensor by its own scalar factor
+         *
+         * This is a common operation when constructing moments, where each tensor is weighted by a mass.
+         *
+         * @param scalars one scalar per tensor in the array
+         * @return the modified array
+         */
+        inline SymmetricTensorArray &operator*=(std::span<const Scalar> scalars) {
+            assert(scalars.size() == size());
+            for (auto &component: _components)
+                for (std::size_t n = 0; n < component.size(); ++n)
+                    component[n] *= scalars[n];
+            return *this;
+        }
+
+        /// @copydoc operator+=(const SymmetricTensorArray &)
+        inline SymmetricTensorArray operator+(const SymmetricTensorArray &other) const {
+            return SymmetricTensorArray{*this} += other;
+        }
+
+        /// @copydoc operator-=(const SymmetricTensorArray &)
+        inline SymmetricTensorArray operator-(const SymmetricTensorArray &other) const {
+            return SymmetricTensorArray{*this} -= other;
+        }
+
+        /// @copydoc operator*=(const Scalar &)
+        inline SymmetricTensorArray operator*(const Scalar &scalar) const {
+            return SymmetricTensorArray{*this} *= scalar;
+        }
+
+        /// @copydoc operator/=(const Scalar &)
+        inline SymmetricTensorArray operator/(const Scalar &scalar) const {
+            return SymmetricTensorArray{*this} /= scalar;
+        }
+
+        /// @}
+    public:
+        /// @name Reductions
+        /// @{
+
+        /**
+         * @brief Sum of all tensors in the array
+         *
+         * @return a single tensor, equivalent to the element-wise sum of every tensor in the array
+         */
+        inline Tensor sum() const {
+            Tensor result{};
+            for (std::size_t i = 0; i < NumUniqueValues; ++i) {
+                Scalar total{0};
+                for (const auto &v: _components[i]) total += v;
+                result[i] = total;
+            }
+            return result;
+        }
+
+        /**
+         * @brief Weighted sum of all tensors in the array
+         *
+         * @param weights one scalar weight per tensor in the array
+         * @return a single tensor, equivalent to the sum of every tensor in the array multiplied by its weight
+         */
+        inline Tensor weightedSum(std::span<const Scalar> weights) const {
+            assert(weights.size() == size());
+            Tensor result{};
+            for (std::size_t i = 0; i < NumUniqueValues; ++i) {
+                Scalar total{0};
+                for (std::size_t n = 0; n < weights.size(); ++n) total += _components[i][n] * weights[n];
+                result[i] = total;
+            }
+            return result;
+        }
+
+        /// @}
+    public:
+        /// @name Comparison operations
+        /// @{
+
+        /**
+         * @brief Comparison with another array
+         *
+         * @param other array to compare with
+         * @return true if both arrays have the same size and all of their tensors are equivalent
+         */
+        inline bool operator==(const SymmetricTensorArray &other) const = default;
+
+        /// @}
+    private:
+
+        template<typename F>
+        inline SymmetricTensorArray &apply(F function) {
+            for (auto &component: _components)
+                for (auto &v: component) function(v);
+            return *this;
+        }
+
+        template<typename F>
+        inline SymmetricTensorArray &apply(const SymmetricTensorArray &other, F function) {
+            assert(other.size() == size());
+            for (std::size_t i = 0; i < NumUniqueValues; ++i)
+                for (std::size_t n = 0; n < _components[i].size(); ++n)
+                    function(_components[i][n], other._components[i][n]);
+            return *this;
+        }
+
+    };
+
+    template<std::size_t R>
+    using SymmetricTensorArray2f = SymmetricTensorArray<float, 2, R>;
+
+    template<std::size_t R>
+    using SymmetricTensorArray3f = SymmetricTensorArray<float, 3, R>;
+
+}
+
+#endif //SYMTENSOR_SYMMETRICTENSORARRAY_H
@@ -9,9 +9,12 @@
 #include "util.h"
 #include "concepts.h"
 #include "Index.h"
+#include "TensorExpression.h"
 
 #include <array>
 #include <iterator>
+#include <cmath>
+#include <span>
 
 namespace symtensor {
 
@@ -34,6 +37,7 @@ namespace symtensor {
         template<std::size_t, class>
         struct ReplaceRankHelper {
         };
+
         template<
                 std::size_t NewRank,
                 template<typename, std::size_t, std::size_t, typename> class ST,
@@ -43,6 +47,309 @@ namespace symtensor {
             using type = ST<S, D, NewRank, I>;
         };
 
+        // A single term of a symmetric outer product: weight * lhs[lhsIndex] * rhs[rhsIndex]
+        struct OuterProductTerm {
+            std::size_t lhsIndex;
+            std::size_t rhsIndex;
+            double weight;
+        };
+
+        // Calls function(lhsIndex, rhsIndex, weight) for every term which contributes to one element of A ⊙ B.
+        // Each way of dividing the multiset of indices into parts of sizes RA and RB contributes once,
+        // with a weight equal to the fraction of the orderings of the index which produce that division.
+        template<std::size_t D, std::size_t RA, std::size_t RB, typename I, typename F>
+        consteval void forEachOuterProductTerm(const std::array<I, RA + RB> &index, F function) {
+            std::array<std::size_t, D> exponents{}, lhsExponents{};
+            for (const auto &i: index) ++exponents[static_cast<std::size_t>(i)];
+
+            // Step through every sub-multiset, like an odometer
+            while (true) {
+                std::size_t lhsRank = 0;
+                for (std::size_t d = 0; d < D; ++d) lhsRank += lhsExponents[d];
+                if (lhsRank == RA) {
+                    std::array<I, RA> lhs{};
+                    std::array<I, RB> rhs{};
+                    std::size_t l = 0, r = 0;
+                    for (std::size_t d = 0; d < D; ++d) {
+                        for (std::size_t k = 0; k < lhsExponents[d]; ++k) lhs[l++] = I(d);
+                        for (std::size_t k = lhsExponents[d]; k < exponents[d]; ++k) rhs[r++] = I(d);
+                    }
+                    function(
+                            flatIndex(lhs, D), flatIndex(rhs, D),
+                            static_cast<double>(num_unique_permutations(lhs) * num_unique_permutations(rhs)) /
+                            static_cast<double>(num_unique_permutations(index))
+                    );
+                }
+
+                std::size_t d = 0;
+                while (d < D && lhsExponents[d] == exponents[d]) lhsExponents[d++] = 0;
+                if (d == D) break;
+                ++lhsExponents[d];
+            }
+        }
+
+        // The terms of every element of A ⊙ B, element i uses terms [offsets[i], offsets[i + 1])
+        template<std::size_t D, std::size_t RA, std::size_t RB, typename I>
+        inline constexpr auto outerProductTable = []() consteval {
+            constexpr std::size_t N = numUniqueValuesInSymmetricTensor(D, RA + RB);
+            constexpr std::size_t NumTerms = []() consteval {
+                std::size_t count = 0;
+                for (std::size_t i = 0; i < N; ++i)
+                    forEachOuterProductTerm<D, RA, RB>(
+                            dimensionalIndices<RA + RB, I>(i, D),
+                            [&](std::size_t, std::size_t, double) { ++count; }
+                    );
+                return count;
+            }();
+
+            struct {
+                std::array<OuterProductTerm, NumTerms> terms;
+                std::array<std::size_t, N + 1> offsets;
+            } table{};
+            std::size_t t = 0;
+            for (std::size_t i = 0; i < N; ++i) {
+                table.offsets[i] = t;
+                forEachOuterProductTerm<D, RA, RB>(
+                        dimensionalIndices<RA + RB, I>(i, D),
+                        [&](std::size_t lhs, std::size_t rhs, double weight) { table.terms[t++] = {lhs, rhs, weight}; }
+                );
+            }
+            table.offsets[N] = t;
+            return table;
+        }();
+
+        // A single term of a sparse linear map between the flat storage of two tensors: weight * input[index]
+        struct LinearMapTerm {
+            std::size_t index;
+            double weight;
+        };
+
+        template<typename Matrix>
+        consteval std::size_t countNonZero(const Matrix &matrix) {
+            std::size_t count = 0;
+            for (const auto &row: matrix)
+                for (const auto &value: row)
+                    if (value > 1e-12 || value < -1e-12) ++count;
+            return count;
+        }
+
+        // Sparse form of a dense linear map, produced at compile-time by DenseMap{}().
+        // Output element i is the sum of the terms in [offsets[i], offsets[i + 1])
+        template<typename DenseMap>
+        inline constexpr auto sparseLinearMap = []() consteval {
+            constexpr auto dense = DenseMap{}();
+            constexpr std::size_t NumTerms = countNonZero(dense);
+            struct {
+                std::array<LinearMapTerm, NumTerms> terms;
+                std::array<std::size_t, dense.size() + 1> offsets;
+            } table{};
+            std::size_t t = 0;
+            for (std::size_t i = 0; i < dense.size(); ++i) {
+                table.offsets[i] = t;
+                for (std::size_t j = 0; j < dense[i].size(); ++j)
+                    if (dense[i][j] > 1e-12 || dense[i][j] < -1e-12)
+                        table.terms[t++] = {j, dense[i][j]};
+            }
+            table.offsets[dense.size()] = t;
+            return table;
+        }();
+
+        // The terms of a sparse linear map, rearranged for use in a loop:
+        // weights are converted ahead of time, and stored apart from the input indices.
+        template<typename DenseMap, typename Weight>
+        inline constexpr auto linearMapLoopTable = []() consteval {
+            constexpr auto &map = sparseLinearMap<DenseMap>;
+            constexpr std::size_t NumTerms = map.terms.size();
+            constexpr std::size_t NumOutputs = map.offsets.size() - 1;
+            struct {
+                std::array<Weight, NumTerms> weights;
+                std::array<std::uint32_t, NumTerms> indices;
+                // When every output has the same number of terms, the inner loop can have a fixed length
+                std::size_t rowLength;
+            } table{};
+            for (std::size_t t = 0; t < NumTerms; ++t) {
+                table.weights[t] = static_cast<Weight>(map.terms[t].weight);
+                table.indices[t] = static_cast<std::uint32_t>(map.terms[t].index);
+            }
+            table.rowLength = NumTerms / NumOutputs;
+            for (std::size_t i = 0; i < NumOutputs; ++i)
+                if (map.offsets[i + 1] - map.offsets[i] != table.rowLength) table.rowLength = 0;
+            return table;
+        }();
+
+        // Computes a single element of the output of a sparse linear map, fully unrolled
+        template<typename Scalar, typename DenseMap, std::size_t i, typename Input>
+        ALWAYS_INLINE constexpr Scalar applyLinearMapRow(const Input &input) {
+            constexpr auto &map = sparseLinearMap<DenseMap>;
+            return [&]<std::size_t... t>(std::index_sequence<t...>) LAMBDA_ALWAYS_INLINE {
+                return (Scalar{0} + ... + (
+                        scalar_cast<Scalar>(map.terms[map.offsets[i] + t].weight) * input[map.terms[map.offsets[i] + t].index]
+                ));
+            }(std::make_index_sequence<map.offsets[i + 1] - map.offsets[i]>());
+        }
+
+        // The flat storage of a tensor, or an array of values as it is.
+        // Tensors are read through their storage, as GCC 12 reports spurious -Warray-bounds
+        // for operator[] on temporary tensors.
+        template<typename Input>
+        ALWAYS_INLINE constexpr const auto &flatValues(const Input &input) {
+            if constexpr (requires { input.flat(); })
+                return input.flat();
+            else
+                return input;
+        }
+
+        // Applies a sparse linear map to the flat storage of a tensor, producing a new tensor
+        template<typename Output, typename DenseMap, typename Input>
+        ALWAYS_INLINE constexpr Output applyLinearMap(const Input &input) {
+            using Scalar = typename Output::Scalar;
+            constexpr auto &map = sparseLinearMap<DenseMap>;
+            const auto &values = flatValues(input);
+            if constexpr (map.terms.size() > SYMTENSOR_UNROLL_THRESHOLD) {
+                using Weight = std::conditional_t<std::is_floating_point_v<Scalar>, Scalar, double>;
+                constexpr auto &table = linearMapLoopTable<DenseMap, Weight>;
+                Output output{};
+                for (std::size_t i = 0; i < Output::NumUniqueValues; ++i) {
+                    Scalar sum{0};
+                    if constexpr (table.rowLength > 0) {
+                        for (std::size_t j = 0; j < table.rowLength; ++j) {
+                            const std::size_t t = i * table.rowLength + j;
+                            sum += scalar_cast<Scalar>(table.weights[t]) * values[table.indices[t]];
+                        }
+                    } else {
+                        for (std::size_t t = map.offsets[i]; t < map.offsets[i + 1]; ++t)
+                            sum += scalar_cast<Scalar>(table.weights[t]) * values[table.indices[t]];
+                    }
+                    output[i] = sum;
+                }
+                return output;
+            } else {
+                return [&]<std::size_t... i>(std::index_sequence<i...>) LAMBDA_ALWAYS_INLINE {
+                    return Output{applyLinearMapRow<Scalar, DenseMap, i>(values)...};
+                }(std::make_index_sequence<Output::NumUniqueValues>());
+            }
+        }
+
+        // Steps to the next way of distributing the same number of items among the entries of counts,
+        // returns false after the last one (when every item is in the final entry)
+        template<std::size_t N>
+        constexpr bool nextComposition(std::array<std::size_t, N> &counts) {
+            // Moves one item from the first non-empty entry to the next one, and the rest back to the start
+            for (std::size_t d = 0; d + 1 < N; ++d) {
+                if (counts[d] == 0) continue;
+                std::size_t moved = counts[d] - 1;
+                counts[d] = 0;
+                ++counts[d + 1];
+                counts[0] += moved;
+                return true;
+            }
+            return false;
+        }
+
+        // Dense matrix which takes a symmetric tensor to its K-fold trace.
+        //
+        // Each element of the result is the sum over every ordered choice of the K dimensions which are contracted,
+        // so each unordered choice (with traced[d] appearances of dimension d) contributes K! / prod_d traced[d]!.
+        template<std::size_t D, std::size_t R, std::size_t K, typename I>
+        struct PartialTraceMatrix {
+            consteval auto operator()() const {
+                constexpr std::size_t ResultRank = R - 2 * K;
+                std::array<
+                        std::array<double, numUniqueValuesInSymmetricTensor(D, R)>,
+                        numUniqueValuesInSymmetricTensor(D, ResultRank)
+                > matrix{};
+                for (std::size_t c = 0; c < matrix.size(); ++c) {
+                    std::array<std::size_t, D> exponents{};
+                    if constexpr (ResultRank > 0)
+                        for (std::size_t d = 0; d < D; ++d) exponents[d] = exponentTable<D, ResultRank, I>[c][d];
+
+                    std::array<std::size_t, D> traced{};
+                    traced[0] = K;
+                    do {
+                        std::array<std::size_t, D> sourceExponents{};
+                        double orderings = static_cast<double>(factorial(K));
+                        for (std::size_t d = 0; d < D; ++d) {
+                            sourceExponents[d] = exponents[d] + 2 * traced[d];
+                            orderings /= static_cast<double>(factorial(traced[d]));
+                        }
+                        matrix[c][exponentFlatIndex<R>(sourceExponents)] += orderings;
+                    } while (nextComposition(traced));
+                }
+                return matrix;
+            }
+        };
+
+        // Dense matrix which takes a symmetric tensor to its traceless projection.
+        //
+        // The projection is a sum over k of a_k times every placement of k Kronecker deltas
+        // on the indices of the k-fold trace of the tensor, where a_k = (-1)^k / prod_{j < k} (2R + D - 4 - 2j).
+        // For an element with exponents e (e[d] is the number of times d appears in its index),
+        // choosing p[d] pairs of the d indices can be done e[d]! / (2^p[d] p[d]! (e[d] - 2 p[d])!) ways,
+        // and the k-fold trace sums over every ordered choice of the k contracted indices.
+        template<std::size_t D, std::size_t R, typename I>
+        struct DetraceMatrix {
+            consteval auto operator()() const {
+                constexpr std::size_t N = numUniqueValuesInSymmetricTensor(D, R);
+                std::array<std::array<double, N>, N> matrix{};
+                for (std::size_t c = 0; c < N; ++c) {
+                    const auto &exponents = exponentTable<D, R, I>[c];
+
+                    // Every way of choosing pairs of repeated indices to replace with a Kronecker delta
+                    std::array<std::size_t, D> pairs{};
+                    while (true) {
+                        std::size_t k = 0;
+                        double placements = 1;
+                        for (std::size_t d = 0; d < D; ++d) {
+                            k += pairs[d];
+                            placements *= static_cast<double>(factorial(exponents[d])) / static_cast<double>(
+                                    pow(2, pairs[d]) * factorial(pairs[d]) * factorial(exponents[d] - 2 * pairs[d])
+                            );
+                        }
+                        double coefficient = (k % 2 == 0) ? 1.0 : -1.0;
+                        for (std::size_t j = 0; j < k; ++j)
+                            coefficient /= static_cast<double>(2 * R + D - 4 - 2 * j);
+
+                        // Every choice of the k dimensions summed over by the trace, counted by the number of orderings
+                        std::array<std::size_t, D> traced{};
+                        traced[0] = k;
+                        do {
+                            std::array<std::size_t, D> sourceExponents{};
+                            double orderings = static_cast<double>(factorial(k));
+                            for (std::size_t d = 0; d < D; ++d) {
+                                sourceExponents[d] = exponents[d] - 2 * pairs[d] + 2 * traced[d];
+                                orderings /= static_cast<double>(factorial(traced[d]));
+                            }
+                            matrix[c][exponentFlatIndex<R>(sourceExponents)] += coefficient * placements * orderings;
+                        } while (nextComposition(traced));
+
+                        // Step to the next choice of pairs
+                        std::size_t d = 0;
+                        while (d < D && 2 * (pairs[d] + 1) > exponents[d]) pairs[d++] = 0;
+                        if (d == D) break;
+                        ++pairs[d];
+                    }
+                }
+                return matrix;
+            }
+        };
+
+        // For each unique index of the result of a contraction, the flat index of the lhs element
+        // which is multiplied by each unique element of the rhs
+        template<std::size_t D, std::size_t R, std::size_t OtherRank, typename I>
+        inline constexpr auto contractionIndexTable = []() consteval {
+            constexpr std::size_t ProductRank = R - OtherRank;
+            std::array<
+                    std::array<std::size_t, numUniqueValuesInSymmetricTensor(D, OtherRank)>,
+                    numUniqueValuesInSymmetricTensor(D, ProductRank)
+            > table{};
+            for (std::size_t i = 0; i < table.size(); ++i)
+                for (std::size_t j = 0; j < table[i].size(); ++j)
+                    table[i][j] = flatIndex(concatenate(
+                            dimensionalIndexTable<D, ProductRank, I>[i],
+                            dimensionalIndexTable<D, OtherRank, I>[j]
+                    ), D);
+            return table;
+        }();
     }
 
     template<class ST, typename S>
@@ -163,9 +470,8 @@ namespace symtensor {
          *
          * @param s a sequence of scalar values to initialize the tensor.
          */
-        explicit constexpr SymmetricTensorBase(auto ...s) : _data{static_cast<S>(s)...} {
-            static_assert(sizeof...(s) == NumUniqueValues);
-        }
+        explicit constexpr SymmetricTensorBase(auto ...s) requires (sizeof...(s) == NumUniqueValues)
+                : _data{scalar_cast<S>(s)...} {}
 
         /**
          * @brief Constructor from an std::array of scalars.
@@ -188,13 +494,32 @@ namespace symtensor {
 
         constexpr Self &operator=(Self &&other) noexcept = default;
 
+        /**
+         * @brief Assignment from a lazy tensor expression.
+         *
+         * The expression is evaluated directly into this tensor, in a single pass.
+         *
+         * @param expression an element-wise expression producing this tensor type
+         * @return the modified tensor
+         */
+        template<tensor_expression E>
+        requires std::same_as<expression_tensor<E>, Implementation>
+        ALWAYS_INLINE constexpr Implementation &operator=(const E &expression) {
+            for (std::size_t i = 0; i < NumUniqueValues; ++i)
+                _data[i] = expression[i];
+            return *static_cast<Implementation *>(this);
+        }
+
         /**
          * @brief Identity matrix constructor.
          *
          * @return a symmetric tensor with a value of 1 along the diagonal, 0 elsewhere.
          */
-        inline static consteval Implementation Identity() {
-            return NullaryExpression([]<auto ...indices>() consteval { return kronecker_delta<float>(indices...); });
+        inline static constexpr Implementation Identity() {
+            return NullaryExpression(overloaded{
+                    []<auto ...indices>() consteval { return kronecker_delta<float>(indices...); },
+                    [](const std::array<I, R> &index) constexpr { return kronecker_delta<float>(index); }
+            });
         }
 
         /**
@@ -202,8 +527,8 @@ namespace symtensor {
          *
          * @return a symmetric tensor with a value of 1 at every index.
          */
-        inline static consteval Implementation Ones() {
-            return NullaryExpression([]<auto ...>() consteval { return Scalar{1}; });
+        inline static constexpr Implementation Ones() {
+            return NullaryExpression([](const auto &) constexpr { return Scalar{1}; });
         }
 
         /**
@@ -211,28 +536,40 @@ namespace symtensor {
          *
          * @return a symmetric tensor with a value of 0 at every index.
          */
-        inline static consteval Implementation Zeros() {
-            return NullaryExpression([]<auto ...>() { return Scalar{0}; });
+        inline static constexpr Implementation Zeros() {
+            return NullaryExpression([](const auto &) constexpr { return Scalar{0}; });
         }
 
         /**
          * @brief Generic constructor from an expression.
          *
+         * Tensors with more than SYMTENSOR_UNROLL_THRESHOLD unique values are filled by a loop,
+         * in which case functions which accept a run-time index are preferred (see @ref overloaded).
+         *
          * @param function a functor which returns a scalar type given an index
          *
          * @return a symmetric tensor with each value set by evaluating the function.
          */
         template<typename F>
         ALWAYS_INLINE static constexpr Implementation NullaryExpression(F function = {}) {
-            if constexpr (requires { function.template operator()<dimensionalIndices(0)>(); }) {
+            constexpr bool CompileTimeIndexed = requires { function.template operator()<dimensionalIndices(0)>(); };
+            constexpr bool RunTimeIndexed = requires { function(dimensionalIndices(0)); };
+            constexpr bool Unrolled = NumUniqueValues <= SYMTENSOR_UNROLL_THRESHOLD;
+            if constexpr (CompileTimeIndexed && (Unrolled || !RunTimeIndexed)) {
                 // If a function provides a template parameter for compile-time indexing, prefer that
                 return [&]<std::size_t... i>(std::index_sequence<i...>) LAMBDA_ALWAYS_INLINE {
-                    return Implementation{static_cast<S>(function.template operator()<dimensionalIndices(i)>())...};
+                    return Implementation{scalar_cast<S>(function.template operator()<dimensionalIndices(i)>())...};
                 }(std::make_index_sequence<NumUniqueValues>());
+            } else if constexpr (!Unrolled) {
+                // Large tensors are filled one element at a time, using a precomputed table of indices
+                Implementation tensor{};
+                for (std::size_t i = 0; i < NumUniqueValues; ++i)
+                    tensor._data[i] = scalar_cast<S>(function(dimensionalIndexTable<D, R, I>[i]));
+                return tensor;
             } else {
                 // Otherwise, the function must take the indices as its only argument
                 return [&]<std::size_t... i>(std::index_sequence<i...>) LAMBDA_ALWAYS_INLINE {
-                    return Implementation{static_cast<S>(function(dimensionalIndices(i)))...};
+                    return Implementation{scalar_cast<S>(function(dimensionalIndices(i)))...};
                 }(std::make_index_sequence<NumUniqueValues>());
             }
         }
@@ -240,21 +577,34 @@ namespace symtensor {
         template<typename F>
         ALWAYS_INLINE static constexpr Implementation LexicographicalNullaryExpression(F function = {}) {
             // todo: There may be cases where this provides a performance benefit
-            Self tensor;
-            if constexpr (requires { function.template operator()<dimensionalIndices(0)>(); }) {
+            Implementation tensor{};
+            constexpr bool CompileTimeIndexed = requires { function.template operator()<dimensionalIndices(0)>(); };
+            constexpr bool RunTimeIndexed = requires { function(dimensionalIndices(0)); };
+            if constexpr (NumValues > SYMTENSOR_UNROLL_THRESHOLD && RunTimeIndexed) {
+                // Step through the indices like an odometer, rather than unrolling all D^R of them
+                std::array<I, R> index{};
+                for (std::size_t i = 0; i < NumValues; ++i) {
+                    tensor[index] = function(index);
+                    for (std::size_t r = R; r-- > 0;) {
+                        index[r] = I(static_cast<std::size_t>(index[r]) + 1);
+                        if (static_cast<std::size_t>(index[r]) < D) break;
+                        index[r] = I(0);
+                    }
+                }
+            } else if constexpr (CompileTimeIndexed) {
                 // If a function provides a template parameter for compile-time indexing, prefer that
                 [&]<std::size_t... i>(std::index_sequence<i...>) LAMBDA_ALWAYS_INLINE {
-                    ((tensor.at<lexicographicalIndices(i)>()
+                    ((tensor.template at<lexicographicalIndices(i)>()
                               = function.template operator()<lexicographicalIndices(i)>()), ...);
                 }(std::make_index_sequence<NumValues>());
             } else {
                 // Otherwise, the function must take the indices as its only argument
                 [&]<std::size_t... i>(std::index_sequence<i...>) LAMBDA_ALWAYS_INLINE {
-                    ((tensor.at<lexicographicalIndices(i)>()
+                    ((tensor.template at<lexicographicalIndices(i)>()
                               = function(lexicographicalIndices(i))), ...);
                 }(std::make_index_sequence<NumValues>());
             }
-            return static_cast<Implementation>(tensor);
+            return tensor;
         }
 
 
@@ -269,11 +619,73 @@ namespace symtensor {
          */
         template<typename Vector>
         inline static constexpr Implementation CartesianPower(const Vector &vector) {
-            return NullaryExpression([&]<std::array<I, Rank> index>() constexpr {
-                return [&]<std::size_t... r>(std::index_sequence<r...>) constexpr {
-                    return (vector[static_cast<std::size_t>(index[r])] * ...);
-                }(std::make_index_sequence<Rank>());
-            });
+            if constexpr (NumUniqueValues > SYMTENSOR_UNROLL_THRESHOLD) {
+                // Each element is a product of powers of the vector's elements,
+                // e.g. the element at index (X, X, Y) is vector[X]^2 * vector[Y]
+                std::array<std::array<Scalar, R + 1>, D> powers{};
+                for (std::size_t d = 0; d < D; ++d) {
+                    powers[d][0] = Scalar{1};
+                    for (std::size_t k = 1; k <= R; ++k)
+                        powers[d][k] = powers[d][k - 1] * vector[d];
+                }
+                constexpr auto &exponents = exponentTable<D, R, I>;
+                Implementation power{};
+                for (std::size_t i = 0; i < NumUniqueValues; ++i) {
+                    Scalar product = powers[0][exponents[i][0]];
+                    for (std::size_t d = 1; d < D; ++d)
+                        product *= powers[d][exponents[i][d]];
+                    power._data[i] = product;
+                }
+                return power;
+            } else {
+                return NullaryExpression([&]<std::array<I, Rank> index>() constexpr {
+                    return [&]<std::size_t... r>(std::index_sequence<r...>) constexpr {
+                        return (vector[static_cast<std::size_t>(index[r])] * ...);
+                    }(std::make_index_sequence<Rank>());
+                });
+            }
+        }
+
+        /**
+         * @brief Constructor by symmetrized outer product.
+         *
+         * Produces \f$ A \odot B \f$, the outer product \f$ A \otimes B \f$ averaged over every permutation of its indices,
+         * so that the result is symmetric. For example, for two vectors
+         * \f$ (a \odot b)_{ij} = \frac{1}{2} (a_i b_j + a_j b_i) \f$.
+         *
+         * The terms which contribute to each element, and their weights, are found at compile-time.
+         * Repeated products with a vector reproduce CartesianPower().
+         *
+         * @tparam TensorA symmetric tensor type of rank RA
+         * @tparam TensorB symmetric tensor type of rank RB, where RA + RB == Rank
+         *
+         * @param a tensor on the left hand side
+         * @param b tensor on the right hand side
+         *
+         * @return a symmetric tensor of rank RA + RB
+         */
+        template<symmetric_tensor<D, I> TensorA, symmetric_tensor<D, I> TensorB>
+        requires (TensorA::Rank + TensorB::Rank == R && TensorA::Rank > 0 && TensorB::Rank > 0)
+        inline static constexpr Implementation SymmetricOuterProduct(const TensorA &a, const TensorB &b) {
+            constexpr auto &table = outerProductTable<D, TensorA::Rank, TensorB::Rank, I>;
+            if constexpr (table.terms.size() > SYMTENSOR_UNROLL_THRESHOLD) {
+                Implementation product{};
+                for (std::size_t i = 0; i < NumUniqueValues; ++i)
+                    for (std::size_t t = table.offsets[i]; t < table.offsets[i + 1]; ++t)
+                        product._data[i] += scalar_cast<Scalar>(table.terms[t].weight) *
+                                            a[table.terms[t].lhsIndex] * b[table.terms[t].rhsIndex];
+                return product;
+            } else {
+                return [&]<std::size_t... i>(std::index_sequence<i...>) LAMBDA_ALWAYS_INLINE {
+                    return Implementation{[&]() LAMBDA_ALWAYS_INLINE {
+                        return [&]<std::size_t... t>(std::index_sequence<t...>) LAMBDA_ALWAYS_INLINE {
+                            constexpr std::size_t first = table.offsets[i];
+                            return ((scalar_cast<Scalar>(table.terms[first + t].weight) *
+                                     a[table.terms[first + t].lhsIndex] * b[table.terms[first + t].rhsIndex]) + ...);
+                        }(std::make_index_sequence<table.offsets[i + 1] - table.offsets[i]>());
+                    }()...};
+                }(std::make_index_sequence<NumUniqueValues>());
+            }
         }
 
         template<typename Tensor, typename Vector>
@@ -352,7 +764,8 @@ namespace symtensor {
         /**
          * @brief Indexed member access
          *
-         * @warning This method is provided only for the sake of completeness, expect poor performance.
+         * The flat index is found using a precomputed table (see @ref tabulatedFlatIndex()),
+         * this is slower than compile-time access with at(), but requires no sorting.
          *
          * @param indices Array of R Index values which specify an element of the tensor.
          *  Indices may be in arbitrary order, because the tensor is symmetric.
@@ -463,6 +876,48 @@ namespace symtensor {
             }(std::make_index_sequence<Dimensions>());
         }
 
+        /**
+         * @brief Computes a partial trace of the tensor
+         *
+         * Contracts K pairs of indices with the Kronecker delta, for example
+         * \f$ A_{ij} = T_{ijkk} \f$ when K is 1 and T has rank 4.
+         * Each element of the result is a weighted sum of elements of this tensor,
+         * with the weights found at compile-time;
+         * the full \f$ D^R \f$ elements of the tensor are never visited.
+         *
+         * @note Unlike trace(), which sums only the diagonal, trace<R / 2>() of a tensor with even rank
+         *  is the complete contraction of every index pair.
+         *
+         * @tparam K the number of index pairs to contract
+         * @return a tensor of rank R - 2K, or a scalar if every index is contracted
+         */
+        template<std::size_t K>
+        requires (K > 0 && 2 * K <= R)
+        inline constexpr auto trace() const {
+            using Map = PartialTraceMatrix<D, R, K, I>;
+            const auto &self = *static_cast<const Implementation *>(this);
+            if constexpr (2 * K == R)
+                return applyLinearMapRow<Scalar, Map, 0>(self);
+            else
+                return applyLinearMap<ReplaceRank<Implementation, R - 2 * K>, Map>(self);
+        }
+
+        /**
+         * @brief Produces the traceless part of the tensor
+         *
+         * Removes every trace from the tensor, so that contracting any pair of indices of the result gives zero.
+         * For a rank-2 tensor this is \f$ A_{ij} - \frac{1}{D} \delta_{ij} A_{kk} \f$;
+         * in general, the result is the sum of the k-fold traces of the tensor,
+         * symmetrized with k Kronecker deltas and weighted by
+         * \f$ (-1)^k / \prod_{j<k} (2R + D - 4 - 2j) \f$.
+         *
+         * The contribution of each element to each element of the result is found at compile-time.
+         *
+         * @return a traceless symmetric tensor of the same type
+         */
+        inline constexpr Implementation detrace() const {
+            return applyLinearMap<Implementation, DetraceMatrix<D, R, I>>(*static_cast<const Implementation *>(this));
+        }
 
         /**
          * The squared Frobenius norm of the tensor.
@@ -470,9 +925,7 @@ namespace symtensor {
          * @return Norm2 of the tensor, with the same type as the tensor's elements.
          */
         inline constexpr auto norm2() const {
-            return [&]<std::size_t... i>(std::index_sequence<i...>) {
-                return ((pow<2>(at<lexicographicalIndices<i>()>())) + ...);
-            }(std::make_index_sequence<NumValues>());
+            return dot(*static_cast<const Implementation *>(this), *static_cast<const Implementation *>(this));
         }
 
         /**
@@ -481,9 +934,35 @@ namespace symtensor {
          * @return Norm of the tensor, with the same type as the tensor's elements.
          */
         inline constexpr auto norm() const {
+            // Unqualified, so that vector scalar types can provide their own sqrt()
+            using std::sqrt;
             return sqrt(norm2());
         }
 
+        /**
+         * @brief Full inner product of two tensors
+         *
+         * Equivalent to the sum of the element-wise product over every (lexicographical) index,
+         * but each unique pair of elements is only multiplied once.
+         *
+         * @param lhs tensor on the left hand side
+         * @param rhs tensor on the right hand side
+         * @return the inner product, with the same type as the tensors' elements.
+         */
+        inline friend constexpr auto dot(const Implementation &lhs, const Implementation &rhs) {
+            if constexpr (NumUniqueValues <= SYMTENSOR_UNROLL_THRESHOLD) {
+                // Each unique pair is multiplied once, and weighted by the number of times it appears in the full tensor
+                return deduplicated_sum<canonicalIndices()>([&]<std::array<I, R> index>() constexpr {
+                    return lhs.template at<index>() * rhs.template at<index>();
+                });
+            } else {
+                Scalar sum{0};
+                for (std::size_t i = 0; i < NumUniqueValues; ++i)
+                    sum += lhs._data[i] * rhs._data[i] * scalar_cast<Scalar>(multiplicityTable<D, R, I>[i]);
+                return sum;
+            }
+        }
+
         /// @}
     public:
         /// @name Tensor-scalar operators
@@ -543,16 +1022,7 @@ namespace symtensor {
         /// @copydoc operator-=(const Scalar &)
         inline constexpr Implementation operator-(const Scalar &scalar) const { return Self{*this} -= scalar; }
 
-        /// @copydoc operator*=(const Scalar &)
-        inline constexpr Implementation operator*(const Scalar &scalar) const { return Self{*this} *= scalar; }
-
-        /// @copydoc operator*=(const Scalar &)
-        inline friend constexpr Implementation operator*(const Scalar &scalar, const Self &tensor) {
-            return tensor * scalar;
-        }
-
-        /// @copydoc operator/=(const Scalar &)
-        inline constexpr Implementation operator/(const Scalar &scalar) const { return Self{*this} /= scalar; }
+        // Multiplication and division by a scalar produce a lazy TensorExpression, see TensorExpression.h
 
         /// @}
     public:
@@ -583,45 +1053,241 @@ namespace symtensor {
             return *static_cast<Implementation *>(this);
         }
 
-        /// @copydoc operator+=(const Implementation &)
-        inline constexpr Implementation operator+(const Implementation &other) const {
-            return Self{*this} += other;
+        /**
+         * @brief Element-wise addition of a lazy tensor expression
+         *
+         * The expression is evaluated directly into this tensor, in a single pass.
+         *
+         * @param expression an element-wise expression producing this tensor type
+         * @return the modified tensor
+         */
+        template<tensor_expression E>
+        requires std::same_as<expression_tensor<E>, Implementation>
+        ALWAYS_INLINE constexpr Implementation &operator+=(const E &expression) {
+            for (std::size_t i = 0; i < NumUniqueValues; ++i)
+                _data[i] += expression[i];
+            return *static_cast<Implementation *>(this);
         }
 
-        /// @copydoc operator-=(const Implementation &)
-        inline constexpr Implementation operator-(const Implementation &other) const {
-            return Self{*this} -= other;
+        /**
+         * @brief Element-wise subtraction of a lazy tensor expression
+         *
+         * The expression is evaluated directly into this tensor, in a single pass.
+         *
+         * @param expression an element-wise expression producing this tensor type
+         * @return the modified tensor
+         */
+        template<tensor_expression E>
+        requires std::same_as<expression_tensor<E>, Implementation>
+        ALWAYS_INLINE constexpr Implementation &operator-=(const E &expression) {
+            for (std::size_t i = 0; i < NumUniqueValues; ++i)
+                _data[i] -= expression[i];
+            return *static_cast<Implementation *>(this);
         }
 
+        // Addition and subtraction of tensors produce a lazy TensorExpression, see TensorExpression.h
+
         /// @}
     public:
         /// @name Other Tensor-tensor operations
         /// @{
 
+        /**
+         * @brief Contraction with a lower-rank symmetric tensor
+         *
+         * Sums over the trailing indices of lhs, \f$ C_{i \dots} = \sum_{j \dots} A_{i \dots j \dots} B_{j \dots} \f$.
+         * Rather than visiting every one of the \f$ D^R \f$ lexicographical indices of lhs,
+         * only the unique indices of the result and of rhs are visited;
+         * each unique index of rhs is weighted by the number of permutations which share its value.
+         *
+         * @param lhs tensor on the left hand side
+         * @param rhs tensor to contract with, of rank no greater than lhs
+         * @return a symmetric tensor of rank Rank - OtherRank,
+         *  or a scalar if both tensors have the same rank
+         */
         template<symmetric_tensor<D, I> OtherTensor>
         requires requires { OtherTensor::Rank; }
-        inline friend auto operator*(
+        inline friend constexpr auto operator*(
                 const Self &lhs,
                 const OtherTensor &rhs
         ) {
 
             constexpr std::size_t OtherRank = OtherTensor::Rank;
             constexpr std::size_t ProductRank = Rank - OtherRank;
-            using ProductTensor = ReplaceRank<Implementation, ProductRank>;
+            static_assert(OtherRank <= Rank, "A tensor can only be contracted with a tensor of equal or lower rank");
+
+            if constexpr (ProductRank == 0) {
+                return contractedElement<OtherTensor, std::array<I, 0>{}>(lhs, rhs);
+            } else if constexpr (numUniqueValuesInSymmetricTensor(D, ProductRank) * OtherTensor::NumUniqueValues >
+                                 SYMTENSOR_UNROLL_THRESHOLD) {
+                // Large contractions loop over a precomputed table of the lhs element used by each term
+                using ProductTensor = ReplaceRank<Implementation, ProductRank>;
+                constexpr auto &lhsIndices = contractionIndexTable<D, Rank, OtherRank, I>;
+                constexpr auto &weights = multiplicityTable<D, OtherRank, I>;
+                ProductTensor product{};
+                for (std::size_t i = 0; i < ProductTensor::NumUniqueValues; ++i)
+                    for (std::size_t j = 0; j < OtherTensor::NumUniqueValues; ++j)
+                        product[i] += lhs._data[lhsIndices[i][j]] * rhs[j] * scalar_cast<Scalar>(weights[j]);
+                return product;
+            } else {
+                using ProductTensor = ReplaceRank<Implementation, ProductRank>;
+                return [&]<std::size_t... i>(std::index_sequence<i...>) LAMBDA_ALWAYS_INLINE {
+                    return ProductTensor{
+                            contractedElement<OtherTensor, ProductTensor::template dimensionalIndices<i>()>(lhs, rhs)...
+                    };
+                }(std::make_index_sequence<ProductTensor::NumUniqueValues>());
+            }
+        }
 
-            // todo: is this correct?
-            ProductTensor product{};
-            [&]<std::size_t... i>(std::index_sequence<i...>) {
-                ((
-                        product.template at<head<Index, Rank, ProductRank>(lexicographicalIndices<i>())>() +=
-                                lhs.template at<lexicographicalIndices<i>()>() *
-                                rhs.template at<(tail<Index, Rank, OtherRank>(lexicographicalIndices<i>()))>()
-                ), ...);
-            }(std::make_index_sequence<NumValues>());
-            return product;
+        /**
+         * @brief Contraction with K copies of a vector
+         *
+         * Computes \f$ C_{i \dots} = A_{i \dots j_1 \dots j_K} x_{j_1} \cdots x_{j_K} \f$,
+         * which is equivalent to contracting with the cartesian power of the vector.
+         * Each unique monomial of the vector is computed once, with the multiplicity of its index folded in,
+         * so that every element of the result is a plain sum over the unique indices of the contracted rank.
+         * With K equal to the rank of the tensor, this evaluates the homogeneous polynomial the tensor represents.
+         *
+         * @tparam K the number of times to contract with the vector
+         * @param vector the vector to contract with
+         * @return a symmetric tensor of rank R - K, or a scalar if K is equal to R
+         */
+        template<std::size_t K, indexable Vector>
+        requires (K > 0 && K <= R)
+        inline constexpr auto contract(const Vector &vector) const {
+            constexpr std::size_t ProductRank = R - K;
+            constexpr std::size_t NumTerms = numUniqueValuesInSymmetricTensor(D, K);
+            const auto monomials = weightedMonomials<K>(vector);
+
+            if constexpr (ProductRank == 0) {
+                if constexpr (NumTerms > SYMTENSOR_UNROLL_THRESHOLD) {
+                    Scalar sum{0};
+                    for (std::size_t j = 0; j < NumTerms; ++j)
+                        sum += _data[j] * monomials[j];
+                    return sum;
+                } else {
+                    return [&]<std::size_t... j>(std::index_sequence<j...>) LAMBDA_ALWAYS_INLINE {
+                        return ((_data[j] * monomials[j]) + ...);
+                    }(std::make_index_sequence<NumTerms>());
+                }
+            } else {
+                using ProductTensor = ReplaceRank<Implementation, ProductRank>;
+                constexpr auto &lhsIndices = contractionIndexTable<D, R, K, I>;
+                if constexpr (ProductTensor::NumUniqueValues * NumTerms > SYMTENSOR_UNROLL_THRESHOLD) {
+                    ProductTensor product{};
+                    for (std::size_t i = 0; i < ProductTensor::NumUniqueValues; ++i) {
+                        Scalar sum{0};
+                        for (std::size_t j = 0; j < NumTerms; ++j)
+                            sum += _data[lhsIndices[i][j]] * monomials[j];
+                        product[i] = sum;
+                    }
+                    return product;
+                } else {
+                    auto element = [&]<std::size_t i>() LAMBDA_ALWAYS_INLINE {
+                        return [&]<std::size_t... j>(std::index_sequence<j...>) LAMBDA_ALWAYS_INLINE {
+                            return ((_data[lhsIndices[i][j]] * monomials[j]) + ...);
+                        }(std::make_index_sequence<NumTerms>());
+                    };
+                    return [&]<std::size_t... i>(std::index_sequence<i...>) LAMBDA_ALWAYS_INLINE {
+                        return ProductTensor{element.template operator()<i>()...};
+                    }(std::make_index_sequence<ProductTensor::NumUniqueValues>());
+                }
+            }
+        }
+
+        /**
+         * @brief Contraction with K copies of each of a sequence of vectors
+         *
+         * Batched form of @ref contract(const Vector &) const, for evaluating one tensor at many points.
+         * Unrolled contractions are vectorized across the vectors by the compiler, but table-driven ones
+         * (above SYMTENSOR_UNROLL_THRESHOLD terms) are not; for those, with arithmetic scalars,
+         * the vectors are gathered into the lanes of a native std::experimental::simd and contracted together,
+         * so that every monomial and every sum is computed for a full set of vectors at once.
+         * Any vectors which don't fill a set are contracted one at a time.
+         *
+         * @tparam K the number of times to contract with each vector
+         * @param vectors the vectors to contract with
+         * @param results output sequence, with the same length as vectors
+         */
+        template<std::size_t K, indexable Vector, typename Result>
+        requires (K > 0 && K <= R)
+        inline void contract(std::span<const Vector> vectors, std::span<Result> results) const {
+            assert(vectors.size() == results.size());
+            std::size_t n = 0;
+#if SYMTENSOR_HAS_SIMD
+            constexpr std::size_t NumTerms = numUniqueValuesInSymmetricTensor(D, K);
+            constexpr std::size_t NumResultValues = numUniqueValuesInSymmetricTensor(D, R - K);
+            if constexpr (std::is_arithmetic_v<Scalar> && NumResultValues * NumTerms > SYMTENSOR_UNROLL_THRESHOLD) {
+                using Lanes = std::experimental::native_simd<Scalar>;
+                using LaneTensor = ReplaceScalar<Implementation, Lanes>;
+                constexpr std::size_t Width = Lanes::size();
+
+                LaneTensor broadcast{};
+                for (std::size_t i = 0; i < NumUniqueValues; ++i)
+                    broadcast[i] = Lanes{_data[i]};
+
+                // Vectors and results are transposed through buffers, one element of every lane at a time
+                alignas(Lanes) std::array<std::array<Scalar, Width>, D> coordinates;
+                alignas(Lanes) std::array<std::array<Scalar, Width>, NumResultValues> values;
+                for (; n + Width <= vectors.size(); n += Width) {
+                    for (std::size_t l = 0; l < Width; ++l)
+                        for (std::size_t d = 0; d < D; ++d)
+                            coordinates[d][l] = scalar_cast<Scalar>(vectors[n + l][d]);
+                    ReplaceRank<LaneTensor, 1> gathered{};
+                    for (std::size_t d = 0; d < D; ++d)
+                        gathered[d].copy_from(coordinates[d].data(), std::experimental::vector_aligned);
+
+                    const auto product = broadcast.template contract<K>(gathered);
+                    if constexpr (K == R) {
+                        product.copy_to(values[0].data(), std::experimental::vector_aligned);
+                        for (std::size_t l = 0; l < Width; ++l)
+                            results[n + l] = values[0][l];
+                    } else {
+                        for (std::size_t i = 0; i < NumResultValues; ++i)
+                            product[i].copy_to(values[i].data(), std::experimental::vector_aligned);
+                        for (std::size_t l = 0; l < Width; ++l)
+                            for (std::size_t i = 0; i < NumResultValues; ++i)
+                                results[n + l][i] = values[i][l];
+                    }
+                }
+            }
+#endif
+            for (; n < vectors.size(); ++n)
+                results[n] = contract<K>(vectors[n]);
         }
 
         /// @}
+    private:
+
+        // Each unique monomial of degree K of a vector, weighted by the number of indices which share it
+        template<std::size_t K, typename Vector>
+        ALWAYS_INLINE static constexpr auto weightedMonomials(const Vector &vector) {
+            using PowerTensor = ReplaceRank<Implementation, K>;
+            auto monomials = PowerTensor::CartesianPower(vector);
+            if constexpr (PowerTensor::NumUniqueValues > SYMTENSOR_UNROLL_THRESHOLD) {
+                for (std::size_t j = 0; j < PowerTensor::NumUniqueValues; ++j)
+                    monomials[j] *= scalar_cast<Scalar>(multiplicityTable<D, K, I>[j]);
+            } else {
+                [&]<std::size_t... j>(std::index_sequence<j...>) LAMBDA_ALWAYS_INLINE {
+                    ((monomials[j] *= scalar_cast<Scalar>(multiplicityTable<D, K, I>[j])), ...);
+                }(std::make_index_sequence<PowerTensor::NumUniqueValues>());
+            }
+            return monomials;
+        }
+
+        template<typename OtherTensor, auto ProductIndex>
+        ALWAYS_INLINE static constexpr Scalar contractedElement(const Self &lhs, const OtherTensor &rhs) {
+            if constexpr (OtherTensor::NumUniqueValues > SYMTENSOR_UNROLL_THRESHOLD) {
+                // Only reachable for full contractions (ProductRank == 0), which are equivalent to dot()
+                Scalar sum{0};
+                for (std::size_t j = 0; j < OtherTensor::NumUniqueValues; ++j)
+                    sum += lhs._data[j] * rhs[j] * scalar_cast<Scalar>(multiplicityTable<D, R, I>[j]);
+                return sum;
+            } else return deduplicated_sum<OtherTensor::canonicalIndices()>([&]<auto otherIndex>() LAMBDA_ALWAYS_INLINE {
+                return lhs.template at<concatenate(ProductIndex, otherIndex)>() * rhs.template at<otherIndex>();
+            });
+        }
+
     public:
         /// @name Comparison operations
         /// @{
@@ -629,21 +1295,29 @@ namespace symtensor {
         /**
          * @brief Comparison with another symmetric tensor
          *
+         * For vector scalar types, elements are only equivalent if every lane is equal.
+         *
          * @param other symmetric tensor to compare with
          * @return true if all elements of the tensors are equivalent, false otherwise
          */
-        inline constexpr bool operator==(const Self &other) const = default;
+        inline constexpr bool operator==(const Self &other) const {
+            for (std::size_t i = 0; i < NumUniqueValues; ++i)
+                if (!all_lanes(_data[i] == other._data[i])) return false;
+            return true;
+        }
 
         /**
          * @brief Inequality comparison between symmetric tensors.
          *
+         * @note For vector scalar types the result is a mask, with each lane compared independently.
+         *
          * @param lhs tensor on the left hand side
          * @param rhs tensor on the right hand side
          * @return true if all elements of lhs are less than or equal to their corresponding elements in rhs
          */
         inline friend auto operator<=(const Implementation &lhs, const Implementation &rhs) {
             return [&]<std::size_t... i>(std::index_sequence<i...>) {
-                ((lhs._data[i] <= rhs._data[i]) && ...);
+                return ((lhs._data[i] <= rhs._data[i]) && ...);
             }(std::make_index_sequence<NumUniqueValues>());
         };
 
@@ -656,7 +1330,7 @@ namespace symtensor {
          */
         inline friend auto operator<(const Implementation &lhs, const Implementation &rhs) {
             return [&]<std::size_t... i>(std::index_sequence<i...>) {
-                ((lhs._data[i] < rhs._data[i]) && ...);
+                return ((lhs._data[i] < rhs._data[i]) && ...);
             }(std::make_index_sequence<NumUniqueValues>());
         };
 
@@ -669,7 +1343,7 @@ namespace symtensor {
          */
         inline friend auto operator>=(const Implementation &lhs, const Implementation &rhs) {
             return [&]<std::size_t... i>(std::index_sequence<i...>) {
-                ((lhs._data[i] >= rhs._data[i]) && ...);
+                return ((lhs._data[i] >= rhs._data[i]) && ...);
             }(std::make_index_sequence<NumUniqueValues>());
         };
 
@@ -682,8 +1356,8 @@ namespace symtensor {
          */
         inline friend auto operator>(const Implementation &lhs, const Implementation &rhs) {
             return [&]<std::size_t... i>(std::index_sequence<i...>) {
-                ((lhs._data[i] > rhs._data[i]) && ...);
-            }(std::make_index_sequence<NumValues>());
+                return ((lhs._data[i] > rhs._data[i]) && ...);
+            }(std::make_index_sequence<NumUniqueValues>());
         };
 
 
@@ -695,20 +1369,22 @@ namespace symtensor {
             return flatIndex(Indices);
         }
 
-        static inline constexpr std::size_t flatIndex(std::array<I, R> indices) {
+        static inline constexpr std::size_t flatIndex(const std::array<I, R> &indices) {
             static_assert(NumValues > 0);
+            return tabulatedFlatIndex<D>(indices);
+        }
 
-            // Use a lookup table when the range of options is small enough
-            //            if constexpr (R < 3)
-            //                return [&]<std::size_t... i>(std::index_sequence<i...>) {
-            //                    return as_lookup_table<
-            //                            decltype([](std::array<I, R> ind) consteval { return symtensor::flatIndex(ind, D); }),
-            //                            std::array<I, R>,
-            //                            lexicographicalIndices(i)...
-            //                    >(indices);
-            //                }(std::make_index_sequence<NumValues>());
-            //            else
-            return symtensor::flatIndex(indices, D);
+        /**
+         * @brief Converts a sequence of indices to flat indices
+         *
+         * @param indices sequence of indices, each in arbitrary order
+         * @param flatIndices output sequence, with the same length as indices
+         */
+        static inline constexpr void flatIndices(
+                std::span<const std::array<I, R>> indices,
+                std::span<std::size_t> flatIndices
+        ) {
+            tabulatedFlatIndices<D>(indices, flatIndices);
         }
 
         static inline constexpr std::array<I, R> dimensionalIndices(std::size_t flatIndex) {
@@ -720,6 +1396,15 @@ namespace symtensor {
             return dimensionalIndices(flatIndex);
         }
 
+        /**
+         * @brief The canonical index of every unique element, in the order they are stored
+         *
+         * @return an array of NumUniqueValues indices, equivalent to dimensionalIndices(i) for each flat index i.
+         */
+        static inline consteval std::array<std::array<I, R>, NumUniqueValues> canonicalIndices() {
+            return dimensionalIndexTable<D, R, I>;
+        }
+
         static inline constexpr std::array<I, R> lexicographicalIndices(std::size_t flatIndex) {
             return symtensor::lexicographicalIndices<R, I>(flatIndex, D);
         }
@@ -735,8 +1420,9 @@ namespace symtensor {
         friend std::ostream &operator<<(std::ostream &out, const Implementation &self) {
             // todo: this should be replaced with something prettier
             out << "[";
-            std::copy(self._data.begin(), self._data.end() - 1, std::ostream_iterator<Scalar>(out, ", "));
-            out << self._data.back() << "]";
+            for (std::size_t i = 0; i < NumUniqueValues; ++i)
+                print_scalar(out << (i == 0 ? "" : ", "), self._data[i]);
+            out << "]";
             return out;
         }
 
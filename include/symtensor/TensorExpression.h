@@ -0,0 +1,267 @@
+/**
+ * @file
+ * @brief Provides lazily-evaluated element-wise expressions of symmetric tensors.
+ */
+#ifndef SYMTENSOR_TENSOREXPRESSION_H
+#define SYMTENSOR_TENSOREXPRESSION_H
+
+#include "platform.h"
+#include "util.h"
+
+#include <cmath>
+#include <functional>
+#include <tuple>
+#include <utility>
+
+namespace symtensor {
+
+    template<class Implementation, typename S, std::size_t D, std::size_t R, typename I>
+    class SymmetricTensorBase;
+
+    template<typename Operation, typename... Operands>
+    class TensorExpression;
+
+    namespace {
+
+        template<class Implementation, typename S, std::size_t D, std::size_t R, typename I>
+        Implementation tensor_implementation_of(const SymmetricTensorBase<Implementation, S, D, R, I> &);
+
+        template<typename T>
+        struct is_tensor_expression : std::false_type {
+        };
+        template<typename Operation, typename... Operands>
+        struct is_tensor_expression<TensorExpression<Operation, Operands...>> : std::true_type {
+        };
+
+    }
+
+    /**
+     * @brief Any type derived from SymmetricTensorBase.
+     */
+    template<typename T>
+    concept symmetric_tensor_type = requires(const std::remove_cvref_t<T> &t) { tensor_implementation_of(t); };
+
+    /**
+     * @brief A lazy element-wise expression of symmetric tensors, see @ref TensorExpression.
+     */
+    template<typename T>
+    concept tensor_expression = is_tensor_expression<std::remove_cvref_t<T>>::value;
+
+    /**
+     * @brief Anything which can appear as the operand of a lazy tensor expression.
+     */
+    template<typename T>
+    concept tensor_operand = symmetric_tensor_type<T> || tensor_expression<T>;
+
+    namespace {
+
+        template<typename... Operands>
+        struct first_tensor_operand {
+        };
+        template<typename First, typename... Rest>
+        struct first_tensor_operand<First, Rest...> {
+            using type = typename std::conditional_t<
+                    tensor_operand<First>,
+                    std::type_identity<First>,
+                    first_tensor_operand<Rest...>
+            >::type;
+        };
+
+        template<typename T>
+        struct expression_tensor_helper {
+            using type = decltype(tensor_implementation_of(std::declval<const T &>()));
+        };
+        template<tensor_expression T>
+        struct expression_tensor_helper<T> {
+            using type = typename T::Tensor;
+        };
+
+    }
+
+    /**
+     * @brief The concrete tensor type produced by evaluating a tensor operand.
+     */
+    template<tensor_operand T>
+    using expression_tensor = typename expression_tensor_helper<std::remove_cvref_t<T>>::type;
+
+    /**
+     * @brief How an operand is held by an expression.
+     *
+     * Tensors passed as lvalues are held by reference, so that no copy is made;
+     * temporaries (and other expressions, which are cheap to copy) are held by value.
+     */
+    template<typename T>
+    using expression_operand = std::conditional_t<
+            std::is_lvalue_reference_v<T> && symmetric_tensor_type<T>,
+            const std::remove_cvref_t<T> &,
+            std::remove_cvref_t<T>
+    >;
+
+    /**
+     * @brief Lazily evaluated element-wise operation on symmetric tensors and scalars.
+     *
+     * Produced by the arithmetic operators (+, -, scalar * and /).
+     * No work is done until the expression is assigned to a tensor (or converted to one),
+     * at which point every element is computed in a single pass, without intermediate tensors.
+     *
+     * @warning Like any expression template, an expression may refer to the tensors it was built from.
+     *  Evaluate it (see eval()) before those tensors go out of scope,
+     *  in particular when returning from a function with a deduced return type.
+     *
+     * @tparam Operation element-wise function object, e.g. std::plus<>
+     * @tparam Operands tensors, expressions, or scalars (which are broadcast to every element)
+     */
+    template<typename Operation, typename... Operands>
+    class TensorExpression {
+    public:
+
+        using Tensor = expression_tensor<typename first_tensor_operand<Operands...>::type>;
+        using Scalar = typename Tensor::Scalar;
+
+        static constexpr std::size_t NumUniqueValues = Tensor::NumUniqueValues;
+
+    private:
+
+        std::tuple<Operands...> _operands;
+
+        template<typename Operand>
+        ALWAYS_INLINE static constexpr auto element(const Operand &operand, std::size_t i) {
+            // Tensors are read through their storage, as GCC 12 reports spurious -Warray-bounds
+            // for operator[] on tensors which are held by value
+            if constexpr (symmetric_tensor_type<Operand>)
+                return operand.flat()[i];
+            else if constexpr (tensor_expression<Operand>)
+                return operand[i];
+            else
+                return operand;
+        }
+
+    public:
+        /// @name Constructors
+        /// @{
+
+        template<typename... Args>
+        requires (sizeof...(Args) == sizeof...(Operands) && sizeof...(Args) > 1)
+        ALWAYS_INLINE explicit constexpr TensorExpression(Args &&...operands) :
+                _operands(std::forward<Args>(operands)...) {}
+
+        /// @}
+    public:
+        /// @name Evaluation
+        /// @{
+
+        /**
+         * @brief Computes a single element of the expression
+         *
+         * @param flatIndex index into the flat storage of the resulting tensor
+         * @return the value of that element
+         */
+        ALWAYS_INLINE constexpr Scalar operator[](std::size_t flatIndex) const {
+            return std::apply([&](const Operands &... operands) LAMBDA_ALWAYS_INLINE {
+                return static_cast<Scalar>(Operation{}(element(operands, flatIndex)...));
+            }, _operands);
+        }
+
+        /**
+         * @brief Evaluates the expression
+         *
+         * @return a tensor containing the result of the expression.
+         */
+        ALWAYS_INLINE constexpr Tensor eval() const {
+            if constexpr (NumUniqueValues <= SYMTENSOR_UNROLL_THRESHOLD) {
+                return [&]<std::size_t... i>(std::index_sequence<i...>) LAMBDA_ALWAYS_INLINE {
+                    return Tensor{std::array<Scalar, NumUniqueValues>{(*this)[i]...}};
+                }(std::make_index_sequence<NumUniqueValues>());
+            } else {
+                Tensor tensor{};
+                tensor = *this;
+                return tensor;
+            }
+        }
+
+        /// @copydoc eval()
+        ALWAYS_INLINE constexpr operator Tensor() const { return eval(); }
+
+        /// @copydoc SymmetricTensorBase::norm2()
+        inline constexpr auto norm2() const { return eval().norm2(); }
+
+        /// @copydoc SymmetricTensorBase::norm()
+        inline constexpr auto norm() const { return eval().norm(); }
+
+        /// @}
+    public:
+
+        inline friend constexpr bool operator==(const TensorExpression &expression, const Tensor &tensor) {
+            return expression.eval() == tensor;
+        }
+
+        friend std::ostream &operator<<(std::ostream &out, const TensorExpression &expression) {
+            return out << expression.eval();
+        }
+
+    };
+
+    /// @name Lazy tensor arithmetic
+    /// @{
+
+    /**
+     * @brief Lazy element-wise addition of two tensors
+     */
+    template<tensor_operand L, tensor_operand R>
+    requires std::same_as<expression_tensor<L>, expression_tensor<R>>
+    ALWAYS_INLINE constexpr auto operator+(L &&lhs, R &&rhs) {
+        return TensorExpression<std::plus<>, expression_operand<L>, expression_operand<R>>{
+                std::forward<L>(lhs), std::forward<R>(rhs)
+        };
+    }
+
+    /**
+     * @brief Lazy element-wise subtraction of two tensors
+     */
+    template<tensor_operand L, tensor_operand R>
+    requires std::same_as<expression_tensor<L>, expression_tensor<R>>
+    ALWAYS_INLINE constexpr auto operator-(L &&lhs, R &&rhs) {
+        return TensorExpression<std::minus<>, expression_operand<L>, expression_operand<R>>{
+                std::forward<L>(lhs), std::forward<R>(rhs)
+        };
+    }
+
+    /**
+     * @brief Lazy multiplication of a tensor by a scalar
+     */
+    template<tensor_operand L, typename S>
+    requires (!tensor_operand<S>) && std::convertible_to<const S &, typename expression_tensor<L>::Scalar>
+    ALWAYS_INLINE constexpr auto operator*(L &&lhs, const S &scalar) {
+        using Scalar = typename expression_tensor<L>::Scalar;
+        return TensorExpression<std::multiplies<>, expression_operand<L>, Scalar>{
+                std::forward<L>(lhs), static_cast<Scalar>(scalar)
+        };
+    }
+
+    /// @copydoc operator*(L &&, const S &)
+    template<typename S, tensor_operand R>
+    requires (!tensor_operand<S>) && std::convertible_to<const S &, typename expression_tensor<R>::Scalar>
+    ALWAYS_INLINE constexpr auto operator*(const S &scalar, R &&rhs) {
+        using Scalar = typename expression_tensor<R>::Scalar;
+        return TensorExpression<std::multiplies<>, Scalar, expression_operand<R>>{
+                static_cast<Scalar>(scalar), std::forward<R>(rhs)
+        };
+    }
+
+    /**
+     * @brief Lazy division of a tensor by a scalar
+     */
+    template<tensor_operand L, typename S>
+    requires (!tensor_operand<S>) && std::convertible_to<const S &, typename expression_tensor<L>::Scalar>
+    ALWAYS_INLINE constexpr auto operator/(L &&lhs, const S &scalar) {
+        using Scalar = typename expression_tensor<L>::Scalar;
+        return TensorExpression<std::divides<>, expression_operand<L>, Scalar>{
+                std::forward<L>(lhs), static_cast<Scalar>(scalar)
+        };
+    }
+
+    /// @}
+
+}
+
+#endif //SYMTENSOR_TENSOREXPRESSION_H
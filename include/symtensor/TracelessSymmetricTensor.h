@@ -0,0 +1,329 @@
+/**
+ * @file
+ * @brief Provides a compressed storage type for traceless symmetric tensors.
+ */
+#ifndef SYMTENSOR_TRACELESSSYMMETRICTENSOR_H
+#define SYMTENSOR_TRACELESSSYMMETRICTENSOR_H
+
+#include <cassert>
+#include <limits>
+
+#include <symtensor/SymmetricTensor.h>
+
+namespace symtensor {
+
+    namespace {
+
+        /// Number of independent values in a traceless symmetric tensor
+        constexpr std::size_t numIndependentValuesInTracelessTensor(std::size_t D, std::size_t R) {
+            return numUniqueValuesInSymmetricTensor(D, R) - (R < 2 ? 0 : numUniqueValuesInSymmetricTensor(D, R - 2));
+        }
+
+        // The flat indices of the elements of a traceless tensor which are stored:
+        // those where the last dimension appears at most once.
+        template<std::size_t D, std::size_t R, typename I>
+        inline constexpr auto independentIndexTable = []() consteval {
+            std::array<std::size_t, numIndependentValuesInTracelessTensor(D, R)> table{};
+            std::size_t j = 0;
+            for (std::size_t i = 0; i < numUniqueValuesInSymmetricTensor(D, R); ++i)
+                if (exponentTable<D, R, I>[i][D - 1] <= 1) table[j++] = i;
+            return table;
+        }();
+
+        // Dense matrix which produces every element of a traceless tensor from its independent elements.
+        //
+        // Removing a trace over the last dimension gives A[m + 2 e_{D-1}] = -sum_{d < D-1} A[m + 2 e_d],
+        // which expresses each element in terms of elements where the last dimension appears twice less often.
+        // Rows are filled in order of the appearances of the last dimension, so each only depends on rows already known.
+        template<std::size_t D, std::size_t R, typename I>
+        struct TracelessExpansionMatrix {
+            consteval auto operator()() const {
+                constexpr std::size_t N = numUniqueValuesInSymmetricTensor(D, R);
+                constexpr std::size_t M = numIndependentValuesInTracelessTensor(D, R);
+                std::array<std::array<double, M>, N> matrix{};
+                for (std::size_t j = 0; j < M; ++j)
+                    matrix[independentIndexTable<D, R, I>[j]][j] = 1;
+                for (std::size_t last = 2; last <= R; ++last) {
+                    for (std::size_t i = 0; i < N; ++i) {
+                        if (exponentTable<D, R, I>[i][D - 1] != last) continue;
+                        for (std::size_t d = 0; d + 1 < D; ++d) {
+                            std::array<std::size_t, D> source{};
+                            for (std::size_t k = 0; k < D; ++k) source[k] = exponentTable<D, R, I>[i][k];
+                            source[D - 1] -= 2;
+                            source[d] += 2;
+                            const auto &row = matrix[exponentFlatIndex<R>(source)];
+                            for (std::size_t j = 0; j < M; ++j)
+                                matrix[i][j] -= row[j];
+                        }
+                    }
+                }
+                return matrix;
+            }
+        };
+
+        // Whether detracing a tensor leaves it unchanged, up to rounding.
+        // Only tensors of floating point scalars are checked.
+        template<typename Tensor>
+        constexpr bool isTraceless(const Tensor &tensor) {
+            using Scalar = typename Tensor::Scalar;
+            if constexpr (Tensor::Rank < 2 || !std::is_floating_point_v<Scalar>) {
+                return true;
+            } else {
+                constexpr Scalar tolerance = 1e3 * std::numeric_limits<Scalar>::epsilon();
+                return (tensor - tensor.detrace()).norm2() <= tolerance * tolerance * tensor.norm2();
+            }
+        }
+
+    }
+
+    /**
+     * @brief Symmetric tensor with no trace, storing only its independent values
+     *
+     * A traceless symmetric tensor is determined by the elements whose index contains the last dimension at most once;
+     * in 3d, that is \f$ 2R + 1 \f$ values rather than \f$ (R + 1)(R + 2) / 2 \f$.
+     * The remaining elements are reconstructed on access, using coefficients found at compile-time.
+     * This is useful for storing traceless multipole moments, such as those produced by SymmetricTensorBase::detrace().
+     *
+     * Because its storage differs, this type does not derive from @ref SymmetricTensorBase;
+     * convert it to a @ref SymmetricTensor (see expanded()) to use operations which are not provided here.
+     * It has the same template parameters, so @ref ReplaceRank and @ref ReplaceScalar apply to it.
+     *
+     * @tparam S scalar type
+     * @tparam D number of dimensions (2d, 3d, etc.)
+     * @tparam R rank
+     * @tparam I index type, defaults to the appropriate @ref Index
+     */
+    template<typename S, std::size_t D, std::size_t R, typename I = Index<D>>
+    class TracelessSymmetricTensor {
+    public:
+
+        using Tensor = SymmetricTensor<S, D, R, I>;
+
+        using Scalar = S;
+        static constexpr std::size_t Dimensions = D;
+        static constexpr std::size_t Rank = R;
+        static constexpr std::size_t NumUniqueValues = Tensor::NumUniqueValues;
+        static constexpr std::size_t NumIndependentValues = numIndependentValuesInTracelessTensor(D, R);
+
+        using Index = I;
+
+    private:
+
+        std::array<S, NumIndependentValues> _data{0};
+
+    public:
+        /// @name Constructors
+        /// @{
+
+        /**
+         * @brief Default constructor.
+         *
+         * Initializes all indices to 0.
+         */
+        explicit constexpr TracelessSymmetricTensor() : _data{0} {}
+
+        /**
+         * @brief Constructor from a sequence of independent values.
+         *
+         * @param s a sequence of scalar values, in the order of @ref independentIndices().
+         */
+        explicit constexpr TracelessSymmetricTensor(auto ...s) requires (sizeof...(s) == NumIndependentValues)
+                : _data{scalar_cast<S>(s)...} {}
+
+        /**
+         * @brief Constructor from an std::array of independent values.
+         *
+         * @param values an array of scalar values, in the order of @ref independentIndices().
+         */
+        explicit constexpr TracelessSymmetricTensor(const std::array<S, NumIndependentValues> &values)
+                : _data{values} {}
+
+        /**
+         * @brief Compression of a traceless symmetric tensor.
+         *
+         * Only the independent elements of the tensor are kept, and the rest are assumed to follow from them.
+         * A tensor with a trace would silently be replaced by a different one,
+         * so apply SymmetricTensorBase::detrace() first where the tensor may not be traceless.
+         *
+         * @pre the tensor is traceless, which is asserted in debug builds
+         * @param tensor a traceless symmetric tensor
+         */
+        explicit constexpr TracelessSymmetricTensor(const Tensor &tensor) {
+            assert(isTraceless(tensor) && "Only traceless tensors can be compressed, see detrace()");
+            for (std::size_t j = 0; j < NumIndependentValues; ++j)
+                _data[j] = tensor[independentIndexTable<D, R, I>[j]];
+        }
+
+        /// @}
+    public:
+        /// @name Member access
+        /// @{
+
+        /**
+         * @brief Reconstructs every element of the tensor
+         *
+         * @return a symmetric tensor with the same value as this one.
+         */
+        inline constexpr Tensor expanded() const {
+            return applyLinearMap<Tensor, TracelessExpansionMatrix<D, R, I>>(_data);
+        }
+
+        /// @copydoc expanded()
+        inline constexpr operator Tensor() const { return expanded(); }
+
+        /**
+         * @brief Runtime-indexed member access
+         *
+         * Elements which are not stored are reconstructed from the independent values.
+         *
+         * @param indices an array of R Index values which specify an element of the tensor, in any order
+         * @return the value of that element
+         */
+        inline constexpr Scalar operator[](const std::array<I, R> &indices) const {
+            constexpr auto &map = sparseLinearMap<TracelessExpansionMatrix<D, R, I>>;
+            const std::size_t i = tabulatedFlatIndex<D>(indices);
+            Scalar value{0};
+            for (std::size_t t = map.offsets[i]; t < map.offsets[i + 1]; ++t)
+                value += scalar_cast<Scalar>(map.terms[t].weight) * _data[map.terms[t].index];
+            return value;
+        }
+
+        /**
+         * @brief Compile-time indexed member access
+         *
+         * The independent values which contribute to the element are resolved at compile-time.
+         *
+         * @tparam Indices Sequence of R Index values which specify an element of the tensor.
+         * @return the value of that element
+         */
+        template<Index... Indices>
+        inline constexpr Scalar at() const {
+            constexpr std::size_t i = Tensor::template flatIndex<std::array<I, R>{static_cast<Index>(Indices)...}>();
+            return applyLinearMapRow<Scalar, TracelessExpansionMatrix<D, R, I>, i>(_data);
+        }
+
+        /**
+         * @brief Direct access to the independent values of the tensor
+         *
+         * @return a reference to the underlying array, in the order of @ref independentIndices()
+         */
+        inline constexpr const auto &flat() const { return _data; }
+
+        /// @copydoc flat() const
+        inline constexpr auto &flat() { return _data; }
+
+        /**
+         * @brief The elements of a full symmetric tensor which are stored by this type
+         *
+         * @return the flat index (in a @ref SymmetricTensor) of each independent value
+         */
+        static constexpr const auto &independentIndices() { return independentIndexTable<D, R, I>; }
+
+        /// @}
+    public:
+        /// @name Tensor-scalar operators
+        /// @{
+
+        /**
+         * @brief Multiplication of the tensor by a scalar
+         *
+         * @param scalar value to multiply each element by
+         * @return the modified tensor
+         */
+        inline constexpr TracelessSymmetricTensor &operator*=(const Scalar &scalar) {
+            for (auto &value: _data) value *= scalar;
+            return *this;
+        }
+
+        /**
+         * @brief Division of the tensor by a scalar
+         *
+         * @param scalar value to divide each element by
+         * @return the modified tensor
+         */
+        inline constexpr TracelessSymmetricTensor &operator/=(const Scalar &scalar) {
+            for (auto &value: _data) value /= scalar;
+            return *this;
+        }
+
+        /// @copydoc operator*=(const Scalar &)
+        inline constexpr TracelessSymmetricTensor operator*(const Scalar &scalar) const {
+            return TracelessSymmetricTensor{*this} *= scalar;
+        }
+
+        /// @copydoc operator/=(const Scalar &)
+        inline constexpr TracelessSymmetricTensor operator/(const Scalar &scalar) const {
+            return TracelessSymmetricTensor{*this} /= scalar;
+        }
+
+        /// @}
+    public:
+        /// @name Tensor-tensor operators
+        /// @{
+
+        /**
+         * @brief Element-wise addition of another traceless tensor
+         *
+         * @param other tensor to add to this one
+         * @return the modified tensor
+         */
+        inline constexpr TracelessSymmetricTensor &operator+=(const TracelessSymmetricTensor &other) {
+            for (std::size_t j = 0; j < NumIndependentValues; ++j) _data[j] += other._data[j];
+            return *this;
+        }
+
+        /**
+         * @brief Element-wise subtraction of another traceless tensor
+         *
+         * @param other tensor to subtract from this one
+         * @return the modified tensor
+         */
+        inline constexpr TracelessSymmetricTensor &operator-=(const TracelessSymmetricTensor &other) {
+            for (std::size_t j = 0; j < NumIndependentValues; ++j) _data[j] -= other._data[j];
+            return *this;
+        }
+
+        /// @copydoc operator+=(const TracelessSymmetricTensor &)
+        inline constexpr TracelessSymmetricTensor operator+(const TracelessSymmetricTensor &other) const {
+            return TracelessSymmetricTensor{*this} += other;
+        }
+
+        /// @copydoc operator-=(const TracelessSymmetricTensor &)
+        inline constexpr TracelessSymmetricTensor operator-(const TracelessSymmetricTensor &other) const {
+            return TracelessSymmetricTensor{*this} -= other;
+        }
+
+        /// @}
+    public:
+        /// @name Comparison operations
+        /// @{
+
+        /**
+         * @brief Comparison with another traceless symmetric tensor
+         *
+         * For vector scalar types, elements are only equivalent if every lane is equal.
+         *
+         * @param other tensor to compare with
+         * @return true if all elements of the tensors are equivalent, false otherwise
+         */
+        inline constexpr bool operator==(const TracelessSymmetricTensor &other) const {
+            for (std::size_t j = 0; j < NumIndependentValues; ++j)
+                if (!all_lanes(_data[j] == other._data[j])) return false;
+            return true;
+        }
+
+        /// @}
+    public:
+
+        friend std::ostream &operator<<(std::ostream &out, const TracelessSymmetricTensor &self) {
+            return out << self.expanded();
+        }
+
+    };
+
+    template<std::size_t R>
+    using TracelessSymmetricTensor3f = TracelessSymmetricTensor<float, 3, R>;
+
+}
+
+#endif //SYMTENSOR_TRACELESSSYMMETRICTENSOR_H
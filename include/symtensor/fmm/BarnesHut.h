@@ -0,0 +1,240 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include <glm/vec3.hpp>
+#include <glm/geometric.hpp>
+
+#include "symtensor/glm.h"
+#include "symtensor/MultipoleMoment.h"
+#include "symtensor/LocalExpansion.h"
+#include "symtensor/gravity/kernels.h"
+
+#include "Octree.h"
+#include "Scheduler.h"
+
+namespace symtensor::fmm {
+
+    /**
+     * @brief Barnes-Hut tree code for Newtonian gravity
+     *
+     * The moment of every node of an Octree is found about its center of mass, where the dipole vanishes.
+     * Each leaf then walks the tree as a group: nodes which pass the opening-angle criterion
+     * \f$ r < \theta d \f$ are accepted, where r is the distance from the node's center of mass to its furthest particle
+     * and d is the distance from that center of mass to the nearest point of the group's bounding sphere.
+     * Accepted nodes act on each particle of the group through gravity::multipoleToLocal() (M2P),
+     * leaves which fail the criterion interact directly (P2P), and all other nodes are opened.
+     *
+     * Unlike Solver, no local expansions are formed, so every particle sees the full multipole of each accepted node.
+     * Groups are independent, and are handed out as tasks of a Scheduler, as is the upward pass.
+     * Units are chosen such that G = 1, and no softening is applied.
+     *
+     * @tparam Order order of the multipole moments
+     * @tparam Backend implementation of the gravity derivatives, see gravity::Direct
+     */
+    template<std::size_t Order, typename Backend = gravity::Direct>
+    class BarnesHut {
+    public:
+
+        using Moment = MultipoleMoment3f<Order>;
+
+        static_assert(Order + 1 <= Backend::MaxOrder,
+                      "The derivative backend does not support moments of this order");
+
+        /// Nodes with fewer particles than this are processed by the task which reaches them, rather than a new one
+        static constexpr std::size_t TaskSize = 1024;
+
+    private:
+
+        float _theta;
+        std::size_t _leafSize;
+        Scheduler *_scheduler;
+
+        // Per-step state, indexed by node or by the particle order of the tree
+        std::vector<Moment> _moments;
+        std::vector<glm::vec3> _centersOfMass;
+        std::vector<float> _radii;
+        std::vector<glm::vec3> _positions;
+        std::vector<float> _masses;
+
+        // Interaction lists and results of a group, reused by each task for the groups it processes
+        struct InteractionLists {
+            std::vector<std::size_t> accepted;
+            std::vector<std::pair<std::size_t, std::size_t>> neighbors;
+            std::vector<std::size_t> stack;
+            std::vector<glm::vec3> accelerations;
+            std::vector<float> fields;
+        };
+
+    public:
+
+        /**
+         * @brief Constructor
+         *
+         * @param theta opening angle, smaller values are more accurate but slower
+         * @param leafSize maximum number of particles in a leaf of the tree, which is also the size of a group
+         * @param scheduler the threads which the solver runs on, which must outlive it
+         */
+        explicit BarnesHut(float theta = 0.5f, std::size_t leafSize = 16, Scheduler &scheduler = Scheduler::global()) :
+                _theta(theta), _leafSize(leafSize), _scheduler(&scheduler) {}
+
+        /**
+         * @brief Computes the gravitational acceleration and potential of every particle
+         *
+         * @param positions location of each particle
+         * @param masses mass of each particle
+         * @param accelerations receives the acceleration of each particle
+         * @param potentials receives the gravitational potential at each particle
+         */
+        void solve(std::span<const glm::vec3> positions, std::span<const float> masses,
+                   std::span<glm::vec3> accelerations, std::span<float> potentials) {
+            assert(positions.size() == masses.size());
+            assert(positions.size() == accelerations.size() && positions.size() == potentials.size());
+
+            Octree tree{positions, _leafSize, *_scheduler};
+            const auto &nodes = tree.nodes();
+
+            // Particles are stored in tree order, so that every node refers to a contiguous range
+            _positions.resize(positions.size());
+            _masses.resize(positions.size());
+            _scheduler->parallelFor(0, positions.size(), TaskSize, [&](std::size_t i) {
+                _positions[i] = positions[tree.order()[i]];
+                _masses[i] = masses[tree.order()[i]];
+            });
+            _moments.assign(nodes.size(), Moment{});
+            _centersOfMass.assign(nodes.size(), glm::vec3{0});
+            _radii.assign(nodes.size(), 0.0f);
+
+            if (nodes.empty()) return;
+            upwardPass(tree, 0);
+
+            TaskGroup groups;
+            InteractionLists lists;
+            evaluateGroups(tree, 0, accelerations, potentials, groups, lists);
+            _scheduler->wait(groups);
+        }
+
+    private:
+
+        // Moments are computed after the moments of every child, so each node waits for its own children
+        void upwardPass(const Octree &tree, std::size_t n) {
+            const auto &nodes = tree.nodes();
+            const auto &node = nodes[n];
+
+            // Moments are accumulated about the geometric center, and then moved to the center of mass
+            Moment moment{};
+            if (node.isLeaf()) {
+                for (std::size_t i = node.begin; i < node.end; ++i)
+                    moment += Moment::FromPosition(_positions[i] - node.center) * _masses[i];
+            } else {
+                TaskGroup children;
+                for (std::size_t c = node.firstChild; c < node.firstChild + node.numChildren; ++c) {
+                    if (nodes[c].size() >= TaskSize)
+                        _scheduler->spawn(children, [this, &tree, c] { upwardPass(tree, c); });
+                    else
+                        upwardPass(tree, c);
+                }
+                _scheduler->wait(children);
+                for (std::size_t c = node.firstChild; c < node.firstChild + node.numChildren; ++c)
+                    moment.addTranslated(_moments[c], _centersOfMass[c] - node.center);
+            }
+            auto &centerOfMass = _centersOfMass[n];
+            centerOfMass = node.center;
+            if (moment.scalar() > 0.0f)
+                centerOfMass += to_glm(moment.template tensor<1>()) / moment.scalar();
+            _moments[n] = moment.translated(node.center - centerOfMass);
+
+            auto &radius = _radii[n];
+            if (node.isLeaf()) {
+                for (std::size_t i = node.begin; i < node.end; ++i)
+                    radius = std::max(radius, glm::length(_positions[i] - centerOfMass));
+            } else {
+                for (std::size_t c = node.firstChild; c < node.firstChild + node.numChildren; ++c)
+                    radius = std::max(radius, glm::length(_centersOfMass[c] - centerOfMass) + _radii[c]);
+            }
+        }
+
+        // Walks the tree for every group (leaf) below node n, and writes the results for their particles
+        void evaluateGroups(const Octree &tree, std::size_t n,
+                            std::span<glm::vec3> accelerations, std::span<float> potentials,
+                            TaskGroup &group, InteractionLists &lists) {
+            const auto &node = tree.nodes()[n];
+            if (node.isLeaf()) {
+                walk(tree, node, lists);
+                evaluate(node, lists);
+                for (std::size_t i = node.begin; i < node.end; ++i) {
+                    accelerations[tree.order()[i]] = lists.accelerations[i - node.begin];
+                    potentials[tree.order()[i]] = -lists.fields[i - node.begin];
+                }
+                return;
+            }
+            for (std::size_t c = node.firstChild; c < node.firstChild + node.numChildren; ++c) {
+                if (tree.nodes()[c].size() >= TaskSize) {
+                    _scheduler->spawn(group, [=, this, &tree, &group] {
+                        InteractionLists taskLists;
+                        evaluateGroups(tree, c, accelerations, potentials, group, taskLists);
+                    });
+                } else {
+                    evaluateGroups(tree, c, accelerations, potentials, group, lists);
+                }
+            }
+        }
+
+        // Fills the interaction lists of a group of particles
+        void walk(const Octree &tree, const Node &group, InteractionLists &lists) const {
+            const auto &nodes = tree.nodes();
+            lists.accepted.clear();
+            lists.neighbors.clear();
+
+            float groupRadius = 0.0f;
+            for (std::size_t i = group.begin; i < group.end; ++i)
+                groupRadius = std::max(groupRadius, glm::length(_positions[i] - group.center));
+
+            auto &stack = lists.stack;
+            stack.assign(1, 0);
+            while (!stack.empty()) {
+                const std::size_t n = stack.back();
+                stack.pop_back();
+                const auto &node = nodes[n];
+
+                // Nodes which contain the group are never accepted, to avoid self-interaction
+                const bool containsGroup = node.begin <= group.begin && group.end <= node.end;
+                const float distance = glm::length(_centersOfMass[n] - group.center) - groupRadius;
+                if (!containsGroup && _radii[n] < _theta * distance)
+                    lists.accepted.push_back(n);
+                else if (node.isLeaf())
+                    lists.neighbors.emplace_back(node.begin, node.end);
+                else
+                    for (std::size_t c = node.firstChild; c < node.firstChild + node.numChildren; ++c)
+                        stack.push_back(c);
+            }
+        }
+
+        // Acceleration and field (the negated potential) at each particle of a group, from its interaction lists
+        void evaluate(const Node &group, InteractionLists &lists) const {
+            lists.accelerations.assign(group.size(), glm::vec3{0});
+            lists.fields.assign(group.size(), 0.0f);
+
+            for (std::size_t i = 0; i < group.size(); ++i) {
+                LocalExpansion3f<1> local{};
+                for (auto n: lists.accepted)
+                    gravity::multipoleToLocal<Backend>(local, _moments[n], _positions[group.begin + i] - _centersOfMass[n]);
+                lists.accelerations[i] += to_glm(local.template tensor<1>());
+                lists.fields[i] += local.scalar();
+            }
+
+            const auto targets = std::span<const glm::vec3>{_positions}.subspan(group.begin, group.size());
+            for (auto [begin, end]: lists.neighbors)
+                gravity::particleToParticle(
+                        targets, lists.accelerations, lists.fields,
+                        std::span<const glm::vec3>{_positions}.subspan(begin, end - begin),
+                        std::span<const float>{_masses}.subspan(begin, end - begin)
+                );
+        }
+    };
+
+}
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <glm/vec3.hpp>
+
+#include "Scheduler.h"
+
+namespace symtensor::fmm {
+
+    /// Number of bits of each coordinate in a Morton key, so that a key fits in 63 bits
+    inline constexpr std::size_t MortonBitsPerDimension = 21;
+
+    /// Deepest level of an octree which can be distinguished by Morton keys
+    inline constexpr std::size_t MortonMaxLevel = MortonBitsPerDimension;
+
+    namespace {
+
+        // Moves the lowest 21 bits of x apart, leaving two zero bits between each
+        constexpr std::uint64_t spreadBits(std::uint64_t x) {
+            x &= 0x1fffff;
+            x = (x | x << 32) & 0x1f00000000ffff;
+            x = (x | x << 16) & 0x1f0000ff0000ff;
+            x = (x | x << 8) & 0x100f00f00f00f00f;
+            x = (x | x << 4) & 0x10c30c30c30c30c3;
+            x = (x | x << 2) & 0x1249249249249249;
+            return x;
+        }
+
+    }
+
+    /**
+     * @brief Morton (Z-order) key of a cell of a 2^21 x 2^21 x 2^21 grid
+     *
+     * The bits of the coordinates are interleaved, with x in the lowest bit of each group of three.
+     * Sorting by key then orders cells depth-first through an octree,
+     * and the group of bits (3 (20 - l)) through (3 (20 - l) + 2) gives the octant of the cell at level l + 1.
+     *
+     * @param cell integer coordinates of the cell, each less than 2^21
+     * @return the 63-bit key
+     */
+    constexpr std::uint64_t mortonKey(std::array<std::uint32_t, 3> cell) {
+        return spreadBits(cell[0]) | spreadBits(cell[1]) << 1 | spreadBits(cell[2]) << 2;
+    }
+
+    /**
+     * @brief Morton key of a position within a cube
+     *
+     * @param position location to encode, expected to be within the cube
+     * @param corner the lowest corner of the cube
+     * @param scale 2^21 divided by the width of the cube
+     * @return the key of the grid cell containing the position, positions outside the cube are clamped to its surface
+     */
+    inline std::uint64_t mortonKey(const glm::vec3 &position, const glm::vec3 &corner, float scale) {
+        constexpr float last = static_cast<float>((1u << MortonBitsPerDimension) - 1);
+        std::array<std::uint32_t, 3> cell{};
+        for (int d = 0; d < 3; ++d)
+            cell[d] = static_cast<std::uint32_t>(std::clamp((position[d] - corner[d]) * scale, 0.0f, last));
+        return mortonKey(cell);
+    }
+
+    /**
+     * @brief Parallel least-significant-digit radix sort of 63-bit keys
+     *
+     * Sorts the keys in place, and applies the same permutation to values.
+     * The sort is stable. Each pass handles 11 bits, so that 63-bit keys take six passes:
+     * every thread counts the digits of its own chunk, the counts are combined into an offset per thread and digit,
+     * and every thread then scatters its chunk independently. Passes where every key shares a digit are skipped.
+     *
+     * @param keys the keys to sort
+     * @param values a value associated with each key, such as the index of a particle
+     * @param scheduler the threads which the sort runs on
+     */
+    inline void radixSort(std::span<std::uint64_t> keys, std::span<std::size_t> values,
+                          Scheduler &scheduler = Scheduler::global()) {
+        constexpr std::size_t Bits = 11, Buckets = 1 << Bits, Grain = 1 << 14;
+        const std::size_t n = keys.size();
+        std::vector<std::uint64_t> keyBuffer(n);
+        std::vector<std::size_t> valueBuffer(n);
+        std::span<std::uint64_t> sourceKeys = keys, destinationKeys = keyBuffer;
+        std::span<std::size_t> sourceValues = values, destinationValues = valueBuffer;
+
+        std::vector<std::array<std::size_t, Buckets>> offsets(scheduler.threads());
+        for (std::size_t shift = 0; shift < 3 * MortonBitsPerDimension; shift += Bits) {
+            auto digit = [=](std::uint64_t key) { return (key >> shift) & (Buckets - 1); };
+
+            const std::size_t chunks = scheduler.parallelChunks(n, Grain, [&](auto begin, auto end, auto c) {
+                offsets[c].fill(0);
+                for (std::size_t i = begin; i < end; ++i)
+                    ++offsets[c][digit(sourceKeys[i])];
+            });
+
+            // Exclusive prefix sum, ordered by digit and then by chunk
+            std::size_t total = 0;
+            bool trivial = false;
+            for (std::size_t b = 0; b < Buckets; ++b) {
+                std::size_t bucketSize = 0;
+                for (std::size_t c = 0; c < chunks; ++c) {
+                    bucketSize += offsets[c][b];
+                    offsets[c][b] = total + bucketSize - offsets[c][b];
+                }
+                total += bucketSize;
+                trivial |= bucketSize == n;
+            }
+            if (trivial) continue;
+
+            scheduler.parallelChunks(n, Grain, [&](std::size_t begin, std::size_t end, std::size_t c) {
+                auto next = offsets[c];
+                for (std::size_t i = begin; i < end; ++i) {
+                    const std::size_t destination = next[digit(sourceKeys[i])]++;
+                    destinationKeys[destination] = sourceKeys[i];
+                    destinationValues[destination] = sourceValues[i];
+                }
+            });
+            std::swap(sourceKeys, destinationKeys);
+            std::swap(sourceValues, destinationValues);
+        }
+
+        // After an odd number of passes, the sorted data is in the buffers
+        if (sourceKeys.data() != keys.data()) {
+            scheduler.parallelChunks(n, Grain, [&](std::size_t begin, std::size_t end, std::size_t) {
+                std::copy(sourceKeys.begin() + begin, sourceKeys.begin() + end, keys.begin() + begin);
+                std::copy(sourceValues.begin() + begin, sourceValues.begin() + end, values.begin() + begin);
+            });
+        }
+    }
+
+}
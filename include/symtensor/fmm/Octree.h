@@ -0,0 +1,191 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <span>
+#include <tuple>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "Morton.h"
+#include "Scheduler.h"
+
+namespace symtensor::fmm {
+
+    /**
+     * @brief A cubic region of space, and the particles within it
+     */
+    struct Node {
+        glm::vec3 center;
+        float halfWidth;
+
+        // Range of the particles within this node, in the order of Octree::order()
+        std::size_t begin;
+        std::size_t end;
+
+        // Children are stored contiguously, starting at firstChild
+        std::size_t firstChild;
+        std::size_t numChildren;
+
+        inline bool isLeaf() const { return numChildren == 0; }
+
+        inline std::size_t size() const { return end - begin; }
+    };
+
+    /**
+     * @brief Spatial subdivision of a set of particles
+     *
+     * Nodes are split into octants until they contain no more than leafSize particles.
+     * The particles of every node are contiguous in order(), and children always come after their parents,
+     * so iterating over nodes() in reverse visits every child before its parent.
+     *
+     * The tree is built in parallel on a Scheduler, from Morton keys (see mortonKey()):
+     * particles are sorted by key with radixSort(), which places the particles of every cell of the tree together.
+     * Nodes are then produced one level at a time; the children of each node of a level are found independently,
+     * by binary searches for the octant digits of its keys, and written after a prefix sum of the number of children.
+     * Particles which share a cell of the finest grid are never separated, so a leaf may exceed leafSize in that case.
+     */
+    class Octree {
+    private:
+
+        std::vector<Node> _nodes;
+        std::vector<std::size_t> _order;
+        std::vector<std::uint64_t> _keys;
+
+    public:
+
+        /**
+         * @brief Builds an octree from a set of positions
+         *
+         * @param positions location of every particle
+         * @param leafSize maximum number of particles in a leaf node
+         * @param scheduler the threads which the tree is built on
+         */
+        Octree(std::span<const glm::vec3> positions, std::size_t leafSize,
+               Scheduler &scheduler = Scheduler::global()) :
+                _order(positions.size()), _keys(positions.size()) {
+            constexpr std::size_t Grain = 1 << 14;
+            const std::size_t n = positions.size();
+
+            // The root node is the smallest cube containing every particle
+            std::vector<std::pair<glm::vec3, glm::vec3>> bounds(scheduler.threads());
+            const std::size_t chunks = scheduler.parallelChunks(n, Grain, [&](auto begin, auto end, auto c) {
+                glm::vec3 min{std::numeric_limits<float>::max()}, max{std::numeric_limits<float>::lowest()};
+                for (std::size_t i = begin; i < end; ++i) {
+                    min = glm::min(min, positions[i]);
+                    max = glm::max(max, positions[i]);
+                }
+                bounds[c] = {min, max};
+            });
+            glm::vec3 min{0}, max{0};
+            if (n > 0) {
+                std::tie(min, max) = bounds[0];
+                for (std::size_t c = 1; c < chunks; ++c) {
+                    min = glm::min(min, bounds[c].first);
+                    max = glm::max(max, bounds[c].second);
+                }
+            }
+            auto extent = max - min;
+            const float halfWidth = std::max({extent.x, extent.y, extent.z}) / 2.0f;
+            const glm::vec3 center = (min + max) / 2.0f;
+            _nodes.push_back({center, halfWidth, 0, n, 0, 0});
+
+            // Particles are sorted by the key of the cell which contains them
+            const glm::vec3 corner = center - halfWidth;
+            const float scale = halfWidth > 0.0f ?
+                                static_cast<float>(1u << MortonBitsPerDimension) / (2.0f * halfWidth) : 0.0f;
+            scheduler.parallelFor(0, n, Grain, [&](std::size_t i) {
+                _keys[i] = mortonKey(positions[i], corner, scale);
+                _order[i] = i;
+            });
+            radixSort(_keys, _order, scheduler);
+
+            // Each level of nodes is split in parallel, producing the next level
+            std::vector<std::size_t> childOffsets;
+            std::size_t levelBegin = 0, levelEnd = 1;
+            for (std::size_t level = 0; level < MortonMaxLevel && levelBegin < levelEnd; ++level) {
+                const std::size_t levelSize = levelEnd - levelBegin;
+                childOffsets.assign(levelSize + 1, 0);
+                scheduler.parallelFor(0, levelSize, 64, [&](std::size_t i) {
+                    const auto &node = _nodes[levelBegin + i];
+                    // Particles which share a key cannot be separated by further splits
+                    if (node.size() <= leafSize || _keys[node.begin] == _keys[node.end - 1]) return;
+                    auto boundaries = octantBoundaries(node, level);
+                    for (std::size_t o = 0; o < 8; ++o)
+                        childOffsets[i + 1] += boundaries[o] != boundaries[o + 1];
+                });
+                std::partial_sum(childOffsets.begin(), childOffsets.end(), childOffsets.begin());
+
+                _nodes.resize(levelEnd + childOffsets.back());
+                scheduler.parallelFor(0, levelSize, 64, [&](std::size_t i) {
+                    auto &node = _nodes[levelBegin + i];
+                    node.firstChild = levelEnd + childOffsets[i];
+                    node.numChildren = childOffsets[i + 1] - childOffsets[i];
+                    if (node.isLeaf()) {
+                        node.firstChild = 0;
+                        return;
+                    }
+
+                    // Only non-empty octants become children
+                    auto boundaries = octantBoundaries(node, level);
+                    const float quarter = node.halfWidth / 2.0f;
+                    std::size_t child = node.firstChild;
+                    for (std::size_t o = 0; o < 8; ++o) {
+                        if (boundaries[o] == boundaries[o + 1]) continue;
+                        _nodes[child++] = {
+                                node.center + glm::vec3{
+                                        (o & 1) ? quarter : -quarter,
+                                        (o & 2) ? quarter : -quarter,
+                                        (o & 4) ? quarter : -quarter
+                                },
+                                quarter,
+                                boundaries[o], boundaries[o + 1],
+                                0, 0
+                        };
+                    }
+                });
+                levelBegin = levelEnd;
+                levelEnd = _nodes.size();
+            }
+        }
+
+        /// All nodes of the tree, starting with the root
+        inline const std::vector<Node> &nodes() const { return _nodes; }
+
+        /// The index of each particle, in the order used by the nodes of the tree
+        inline const std::vector<std::size_t> &order() const { return _order; }
+
+        /// The Morton key of each particle, in the order used by the nodes of the tree
+        inline const std::vector<std::uint64_t> &keys() const { return _keys; }
+
+        inline const Node &root() const { return _nodes[0]; }
+
+        inline std::span<const Node> children(const Node &node) const {
+            return std::span{_nodes}.subspan(node.firstChild, node.numChildren);
+        }
+
+    private:
+
+        // The first particle of each octant of a node at the given level, followed by the end of the node.
+        // Keys within the node share every digit above the level, so each octant is a contiguous run.
+        std::array<std::size_t, 9> octantBoundaries(const Node &node, std::size_t level) const {
+            const std::size_t shift = 3 * (MortonMaxLevel - 1 - level);
+            std::array<std::size_t, 9> boundaries{};
+            boundaries[0] = node.begin;
+            boundaries[8] = node.end;
+            auto keys = std::span{_keys}.subspan(node.begin, node.size());
+            for (std::size_t o = 1; o < 8; ++o) {
+                auto first = std::partition_point(keys.begin(), keys.end(), [&](std::uint64_t key) {
+                    return ((key >> shift) & 7) < o;
+                });
+                boundaries[o] = node.begin + static_cast<std::size_t>(first - keys.begin());
+            }
+            return boundaries;
+        }
+    };
+
+}
@@ -0,0 +1,243 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "parallel.h"
+
+namespace symtensor::fmm {
+
+    /**
+     * @brief A set of tasks which can be waited on together
+     *
+     * Tasks may spawn further tasks into the group they belong to;
+     * Scheduler::wait() only returns once all of them are done.
+     */
+    class TaskGroup {
+    private:
+        friend class Scheduler;
+
+        std::atomic<std::size_t> _pending{0};
+    };
+
+    /**
+     * @brief Work-stealing task scheduler
+     *
+     * Each worker thread owns a deque of tasks. New tasks are pushed to the back of the spawning thread's deque,
+     * and workers take their own most recent tasks first, so that work which splits recursively is done depth-first.
+     * Idle workers steal from the front of other deques, taking the oldest, and usually largest, tasks.
+     * Workers which find no work at all sleep until a task is spawned.
+     *
+     * The thread which waits on a TaskGroup runs tasks while it waits, so tasks may spawn and wait on nested groups.
+     * Threads which are not workers of the scheduler (such as the one which created it) share the first deque.
+     * Tasks must not throw.
+     */
+    class Scheduler {
+    private:
+
+        struct Worker {
+            std::mutex mutex;
+            std::deque<std::function<void()>> tasks;
+        };
+
+        std::vector<std::unique_ptr<Worker>> _workers;
+        std::vector<std::jthread> _threads;
+
+        // Tasks which have been spawned but not yet started, and the number of workers waiting for one
+        std::atomic<std::size_t> _queued{0};
+        std::atomic<std::size_t> _sleeping{0};
+        std::atomic<bool> _stopping{false};
+        std::mutex _mutex;
+        std::condition_variable _wake;
+
+        // The scheduler the current thread works for, if any, and its index among the workers
+        static inline thread_local const Scheduler *_currentScheduler = nullptr;
+        static inline thread_local std::size_t _currentWorker = 0;
+
+    public:
+
+        /**
+         * @brief Constructor
+         *
+         * @param threads total number of threads which run tasks, including the thread which waits on them
+         */
+        explicit Scheduler(std::size_t threads = concurrency()) : _workers(std::max<std::size_t>(threads, 1)) {
+            for (auto &worker: _workers) worker = std::make_unique<Worker>();
+            for (std::size_t i = 1; i < _workers.size(); ++i)
+                _threads.emplace_back([this, i] { work(i); });
+        }
+
+        Scheduler(const Scheduler &) = delete;
+
+        Scheduler &operator=(const Scheduler &) = delete;
+
+        ~Scheduler() {
+            {
+                std::lock_guard lock{_mutex};
+                _stopping = true;
+            }
+            _wake.notify_all();
+            _threads.clear();
+        }
+
+        /// A scheduler with one thread for each core, shared by every solver which isn't given one
+        static Scheduler &global() {
+            static Scheduler scheduler{};
+            return scheduler;
+        }
+
+        /// Number of threads which run tasks, including the thread which waits on them
+        inline std::size_t threads() const { return _workers.size(); }
+
+        /**
+         * @brief Adds a task to a group, to be run by any thread
+         *
+         * @param group the group which the task belongs to
+         * @param task a copyable callable taking no arguments
+         */
+        template<typename Task>
+        void spawn(TaskGroup &group, Task &&task) {
+            group._pending.fetch_add(1);
+            auto &worker = *_workers[currentWorker()];
+            {
+                std::lock_guard lock{worker.mutex};
+                worker.tasks.emplace_back([&group, task = std::forward<Task>(task)]() mutable {
+                    task();
+                    group._pending.fetch_sub(1, std::memory_order_release);
+                });
+            }
+
+            // Sleeping workers check for queued tasks while holding the mutex, so taking it here can't miss one
+            _queued.fetch_add(1);
+            if (_sleeping.load() > 0) {
+                { std::lock_guard lock{_mutex}; }
+                _wake.notify_one();
+            }
+        }
+
+        /**
+         * @brief Runs tasks until every task of a group is done
+         *
+         * @param group the group to wait for
+         */
+        void wait(TaskGroup &group) {
+            const std::size_t self = currentWorker();
+            while (group._pending.load(std::memory_order_acquire) > 0)
+                if (!runOne(self)) std::this_thread::yield();
+        }
+
+        /**
+         * @brief Calls function(i) for every i in [begin, end)
+         *
+         * The range is split in half recursively, spawning a task for one half each time, until it is no larger than grain.
+         *
+         * @param begin the first index
+         * @param end one past the last index
+         * @param grain the largest range which is run as a single task
+         * @param function callable taking an index
+         */
+        template<typename Function>
+        void parallelFor(std::size_t begin, std::size_t end, std::size_t grain, const Function &function) {
+            TaskGroup group;
+            splitRange(group, begin, end, std::max<std::size_t>(grain, 1), function);
+            wait(group);
+        }
+
+        /**
+         * @brief Calls function(begin, end, chunk) for contiguous chunks of [0, count)
+         *
+         * Splits the range into at most threads() chunks of at least grain elements, each run as a task,
+         * for loops which keep a partial result per chunk (such as a reduction or a histogram).
+         * The calling thread processes the first chunk, and the call returns once every chunk is done.
+         *
+         * @param count number of elements in the range
+         * @param grain minimum number of elements worth running as a separate task
+         * @param function callable taking the bounds and the index of a chunk
+         * @return the number of chunks used, which is never more than threads()
+         */
+        template<typename Function>
+        std::size_t parallelChunks(std::size_t count, std::size_t grain, const Function &function) {
+            const std::size_t chunks = std::clamp<std::size_t>(count / std::max<std::size_t>(grain, 1), 1, threads());
+            TaskGroup group;
+            for (std::size_t c = 1; c < chunks; ++c)
+                spawn(group, [&function, c, chunks, count] {
+                    function(c * count / chunks, (c + 1) * count / chunks, c);
+                });
+            function(std::size_t{0}, count / chunks, std::size_t{0});
+            wait(group);
+            return chunks;
+        }
+
+    private:
+
+        inline std::size_t currentWorker() const { return _currentScheduler == this ? _currentWorker : 0; }
+
+        template<typename Function>
+        void splitRange(TaskGroup &group, std::size_t begin, std::size_t end, std::size_t grain,
+                        const Function &function) {
+            while (end - begin > grain) {
+                const std::size_t middle = begin + (end - begin) / 2;
+                spawn(group, [this, &group, middle, end, grain, &function] {
+                    splitRange(group, middle, end, grain, function);
+                });
+                end = middle;
+            }
+            for (std::size_t i = begin; i < end; ++i) function(i);
+        }
+
+        // Runs one task, from the worker's own deque if possible and stolen otherwise
+        bool runOne(std::size_t self) {
+            std::function<void()> task;
+            {
+                auto &worker = *_workers[self];
+                std::lock_guard lock{worker.mutex};
+                if (!worker.tasks.empty()) {
+                    task = std::move(worker.tasks.back());
+                    worker.tasks.pop_back();
+                }
+            }
+            for (std::size_t k = 1; !task && k < _workers.size(); ++k) {
+                auto &victim = *_workers[(self + k) % _workers.size()];
+                std::lock_guard lock{victim.mutex};
+                if (!victim.tasks.empty()) {
+                    task = std::move(victim.tasks.front());
+                    victim.tasks.pop_front();
+                }
+            }
+            if (!task) return false;
+
+            _queued.fetch_sub(1);
+            task();
+            return true;
+        }
+
+        void work(std::size_t self) {
+            _currentScheduler = this;
+            _currentWorker = self;
+            while (!_stopping.load()) {
+                if (runOne(self)) continue;
+
+                // Tasks are often spawned in quick succession, so briefly look for more before sleeping
+                bool found = false;
+                for (int attempt = 0; attempt < 64 && !found; ++attempt) {
+                    std::this_thread::yield();
+                    found = _queued.load() > 0;
+                }
+                if (found) continue;
+
+                std::unique_lock lock{_mutex};
+                _sleeping.fetch_add(1);
+                _wake.wait(lock, [&] { return _stopping.load() || _queued.load() > 0; });
+                _sleeping.fetch_sub(1);
+            }
+        }
+    };
+
+}
@@ -0,0 +1,236 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <span>
+#include <vector>
+
+#include <glm/vec3.hpp>
+#include <glm/geometric.hpp>
+
+#include "symtensor/MultipoleMoment.h"
+#include "symtensor/LocalExpansion.h"
+#include "symtensor/gravity/kernels.h"
+
+#include "Octree.h"
+#include "Scheduler.h"
+
+namespace symtensor::fmm {
+
+    /**
+     * @brief Fast Multipole Method solver for Newtonian gravity
+     *
+     * Each step of the method is built from the operations provided by the rest of the library:
+     *  - Upward pass: the moment of each leaf is summed from its particles (P2M),
+     *    and carried to its parent with MultipoleMoment::addTranslated() (M2M).
+     *  - Dual-tree traversal: pairs of nodes which pass the multipole acceptance criterion
+     *    \f$ r_A + r_B < \theta |c_A - c_B| \f$, where r is the distance from a node's center to its furthest particle,
+     *    interact through gravity::multipoleToLocal() (M2L).
+     *    Pairs of leaves which fail it interact directly (P2P), and otherwise the larger node is split.
+     *  - Downward pass: local expansions are pushed to children by LocalExpansion::translated() (L2L),
+     *    and evaluated at the particles of each leaf by LocalExpansion::evaluate() (L2P).
+     *
+     * Every step runs on a Scheduler, with a task spawned for each child of a node holding at least TaskSize particles.
+     * The traversal is done from the side of each target node: a call handles every interaction of its target,
+     * and passes the sources which need a finer target on to its children,
+     * so each task writes only to the subtree it was given.
+     *
+     * Units are chosen such that G = 1, and no softening is applied.
+     *
+     * @tparam Order order of the multipole moments
+     * @tparam Backend implementation of the gravity derivatives, see gravity::Direct
+     * @tparam LocalOrder order of the local expansions.
+     *  Accelerations are the gradient of the local expansion, so by default it has one order more than the moments.
+     */
+    template<std::size_t Order, typename Backend = gravity::Direct, std::size_t LocalOrder = Order + 1>
+    class Solver {
+    public:
+
+        using Moment = MultipoleMoment3f<Order>;
+        using Local = LocalExpansion3f<LocalOrder>;
+
+        static_assert(Order + LocalOrder <= Backend::MaxOrder,
+                      "The derivative backend does not support expansions of this order");
+
+        /// Nodes with fewer particles than this are processed by the task which reaches them, rather than a new one
+        static constexpr std::size_t TaskSize = 1024;
+
+    private:
+
+        float _theta;
+        std::size_t _leafSize;
+        Scheduler *_scheduler;
+
+        // Per-step state, indexed by node or by the particle order of the tree
+        std::vector<Moment> _moments;
+        std::vector<float> _radii;
+        std::vector<Local> _locals;
+        std::vector<glm::vec3> _positions;
+        std::vector<float> _masses;
+        std::vector<glm::vec3> _accelerations;
+        std::vector<float> _fields;
+
+    public:
+
+        /**
+         * @brief Constructor
+         *
+         * @param theta opening angle, smaller values are more accurate but slower
+         * @param leafSize maximum number of particles in a leaf of the tree
+         * @param scheduler the threads which the solver runs on, which must outlive it
+         */
+        explicit Solver(float theta = 0.5f, std::size_t leafSize = 32, Scheduler &scheduler = Scheduler::global()) :
+                _theta(theta), _leafSize(leafSize), _scheduler(&scheduler) {}
+
+        /**
+         * @brief Computes the gravitational acceleration and potential of every particle
+         *
+         * @param positions location of each particle
+         * @param masses mass of each particle
+         * @param accelerations receives the acceleration of each particle
+         * @param potentials receives the gravitational potential at each particle
+         */
+        void solve(std::span<const glm::vec3> positions, std::span<const float> masses,
+                   std::span<glm::vec3> accelerations, std::span<float> potentials) {
+            assert(positions.size() == masses.size());
+            assert(positions.size() == accelerations.size() && positions.size() == potentials.size());
+
+            Octree tree{positions, _leafSize, *_scheduler};
+            const auto &nodes = tree.nodes();
+
+            // Particles are stored in tree order, so that every node refers to a contiguous range
+            _positions.resize(positions.size());
+            _masses.resize(positions.size());
+            _scheduler->parallelFor(0, positions.size(), TaskSize, [&](std::size_t i) {
+                _positions[i] = positions[tree.order()[i]];
+                _masses[i] = masses[tree.order()[i]];
+            });
+            _accelerations.assign(positions.size(), glm::vec3{0});
+            _fields.assign(positions.size(), 0.0f);
+            _moments.assign(nodes.size(), Moment{});
+            _radii.assign(nodes.size(), 0.0f);
+            _locals.assign(nodes.size(), Local{});
+
+            if (!nodes.empty()) {
+                upwardPass(tree, 0);
+
+                TaskGroup traversal;
+                interact(tree, 0, {0}, traversal);
+                _scheduler->wait(traversal);
+
+                TaskGroup downward;
+                downwardPass(tree, 0, downward);
+                _scheduler->wait(downward);
+            }
+
+            _scheduler->parallelFor(0, positions.size(), TaskSize, [&](std::size_t i) {
+                accelerations[tree.order()[i]] = _accelerations[i];
+                potentials[tree.order()[i]] = -_fields[i];
+            });
+        }
+
+    private:
+
+        // Runs function(child) for each child of a node, with a new task for each child which is large enough
+        template<typename Function>
+        inline void forEachChild(const Octree &tree, const Node &node, TaskGroup &group, const Function &function) {
+            for (std::size_t c = node.firstChild; c < node.firstChild + node.numChildren; ++c) {
+                if (tree.nodes()[c].size() >= TaskSize)
+                    _scheduler->spawn(group, [function, c] { function(c); });
+                else
+                    function(c);
+            }
+        }
+
+        // Moments are computed after the moments of every child, so each node waits for its own children
+        void upwardPass(const Octree &tree, std::size_t n) {
+            const auto &nodes = tree.nodes();
+            const auto &node = nodes[n];
+            auto &moment = _moments[n];
+            auto &radius = _radii[n];
+            if (node.isLeaf()) {
+                for (std::size_t i = node.begin; i < node.end; ++i) {
+                    moment += Moment::FromPosition(_positions[i] - node.center) * _masses[i];
+                    radius = std::max(radius, glm::length(_positions[i] - node.center));
+                }
+            } else {
+                TaskGroup children;
+                auto recurse = [&](std::size_t c) { upwardPass(tree, c); };
+                forEachChild(tree, node, children, recurse);
+                _scheduler->wait(children);
+                for (std::size_t c = node.firstChild; c < node.firstChild + node.numChildren; ++c) {
+                    moment.addTranslated(_moments[c], nodes[c].center - node.center);
+                    radius = std::max(radius, glm::length(nodes[c].center - node.center) + _radii[c]);
+                }
+            }
+        }
+
+        // Adds the field due to the particles of each source node to target node a, and its descendants.
+        // Sources which are too close to the target and no larger than it are deferred to the children of the target,
+        // so every interaction of a subtree happens within one call, and its children can be separate tasks.
+        void interact(const Octree &tree, std::size_t a, std::vector<std::size_t> sources, TaskGroup &group) {
+            const auto &nodes = tree.nodes();
+            const auto &A = nodes[a];
+
+            std::vector<std::size_t> deferred;
+            while (!sources.empty()) {
+                const std::size_t b = sources.back();
+                sources.pop_back();
+                const auto &B = nodes[b];
+
+                // A node is deferred to its children along with its other sources, so a source may be an ancestor of
+                // the target; sources which contain the target are never accepted, to avoid self-interaction
+                const bool containsTarget = B.begin <= A.begin && A.end <= B.end;
+                const auto separation = A.center - B.center;
+                if (!containsTarget && _radii[a] + _radii[b] < _theta * glm::length(separation)) {
+                    gravity::multipoleToLocal<Backend>(_locals[a], _moments[b], separation);
+                } else if (A.isLeaf() && B.isLeaf()) {
+                    particleInteraction(A, B);
+                } else if (B.isLeaf() || (!A.isLeaf() && A.halfWidth >= B.halfWidth)) {
+                    deferred.push_back(b);
+                } else {
+                    for (std::size_t j = B.firstChild; j < B.firstChild + B.numChildren; ++j)
+                        sources.push_back(j);
+                }
+            }
+            if (deferred.empty()) return;
+
+            forEachChild(tree, A, group, [this, &tree, deferred, &group](std::size_t i) {
+                interact(tree, i, deferred, group);
+            });
+        }
+
+        // The local expansion of a node is complete before it is passed to its children
+        void downwardPass(const Octree &tree, std::size_t n, TaskGroup &group) {
+            const auto &nodes = tree.nodes();
+            const auto &node = nodes[n];
+            if (node.isLeaf()) {
+                _locals[n].evaluate(
+                        node.center,
+                        std::span<const glm::vec3>{_positions}.subspan(node.begin, node.size()),
+                        std::span{_accelerations}.subspan(node.begin, node.size()),
+                        std::span{_fields}.subspan(node.begin, node.size())
+                );
+            } else {
+                for (std::size_t c = node.firstChild; c < node.firstChild + node.numChildren; ++c)
+                    _locals[c] += _locals[n].translated(nodes[c].center - node.center);
+                forEachChild(tree, node, group, [this, &tree, &group](std::size_t c) {
+                    downwardPass(tree, c, group);
+                });
+            }
+        }
+
+        // Direct interaction (P2P) of the particles of a source leaf with those of a target leaf
+        inline void particleInteraction(const Node &target, const Node &source) {
+            gravity::particleToParticle(
+                    std::span<const glm::vec3>{_positions}.subspan(target.begin, target.size()),
+                    std::span{_accelerations}.subspan(target.begin, target.size()),
+                    std::span{_fields}.subspan(target.begin, target.size()),
+                    std::span<const glm::vec3>{_positions}.subspan(source.begin, source.size()),
+                    std::span<const float>{_masses}.subspan(source.begin, source.size())
+            );
+        }
+    };
+
+}
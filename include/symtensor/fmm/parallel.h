@@ -0,0 +1,14 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+
+namespace symtensor::fmm {
+
+    /// Number of cores, the default number of threads of a Scheduler
+    inline std::size_t concurrency() {
+        return std::max<std::size_t>(1, std::thread::hardware_concurrency());
+    }
+
+}
@@ -31,6 +31,11 @@ namespace symtensor {
         return result;
     }
 
+    template<tensor_expression Expression>
+    constexpr static inline auto to_glm(const Expression &expression) {
+        return to_glm(expression.eval());
+    }
+
 }
 
 #endif //SYMTENSOR_GLM_H
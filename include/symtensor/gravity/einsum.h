@@ -7,94 +7,202 @@
 #include "symtensor/symtensor.h"
 #include "symtensor/util.h"
 
+#include "radial.h"
+
 namespace symtensor::gravity::einsum {
 
-    template<auto index, indexable Vector>
-    inline constexpr auto product_of_elements(const Vector &v) {
-        return std::apply([=](auto ...i) {
-            return (v[static_cast<std::size_t>(i)] * ...);
-        }, index);
-    }
+    namespace {
 
-    template<auto index, std::size_t N, indexable Vector>
-    ALWAYS_INLINE auto derivative_at(const Vector &R) {
-
-        auto r2 = glm::length2(R);
-        auto r = std::sqrt(r2);
-        auto inv_r2 = 1.0f / r2;
-        auto g1 = -inv_r2 / r;
-        auto g2 = -3.0f * g1 * inv_r2;
-        auto g3 = -5.0f * g2 * inv_r2;
-        auto g4 = -7.0f * g3 * inv_r2;
-        auto g5 = -9.0f * g4 * inv_r2;
-
-        //        auto r = glm::length(R);
-        //        auto g1 = -1.0f / pow<3>(r);
-        //        auto g2 = 3.0f / pow<5>(r);
-        //        auto g3 = -15.0f / pow<7>(r);
-        //        auto g4 = 105.0f / pow<9>(r);
-        //        auto g5 = -945.0f / pow<11>(r);
-
-        auto cartesian_product_term = product_of_elements<index>(R);
-        if constexpr (N == 1) {
-            return R[static_cast<std::size_t>(index[0])] * g1;
-        } else if constexpr (N == 2) {
-            return g1 * kronecker_delta<float>(index) + g2 * cartesian_product_term;
-        } else if constexpr (N == 3) {
-            constexpr auto partitions = binomial_partitions<1>(index);
-            constexpr auto r_indices = std::get<0>(unzip(partitions));
-            constexpr auto kronecker_indices = std::get<1>(unzip(partitions));
-            constexpr auto repeats = repeats_table(kronecker_indices);
-            auto kronecker_product_term = [=]<auto... i>(std::index_sequence<i...>) LAMBDA_ALWAYS_INLINE {
-                    return ((
-                    force_consteval<kronecker_delta<kronecker_indices[i]>() && (repeats[i] > 0)> ?
-                    product_of_elements<r_indices[i]>(R) * repeats[i] : 0
-                    ) + ...);
-            }(std::make_index_sequence<kronecker_indices.size()>());
-            return g2 * kronecker_product_term + g3 * cartesian_product_term;
-        } else if constexpr (N == 4) {
-            auto result = g4 * cartesian_product_term;
-            constexpr auto partitions = binomial_partitions<2>(index);
-            constexpr auto kronecker_indices = std::get<0>(unzip(partitions));
-            constexpr auto r_indices = std::get<1>(unzip(partitions));
-            {
-                constexpr auto kronecker_term = [=]<auto... i>(std::index_sequence<i...>) constexpr {
-                    return ((kronecker_delta(kronecker_indices[i]) & kronecker_delta(r_indices[i])) + ...);
-                }(std::make_index_sequence<kronecker_indices.size() / 2>());
-                result += g2 * kronecker_term;
-            }
-            {
-                constexpr auto repeats = repeats_table(kronecker_indices);
-                auto kronecker_product_term = [=]<auto... i>(std::index_sequence<i...>) LAMBDA_ALWAYS_INLINE {
-                        return ((
-                        force_consteval<kronecker_delta<kronecker_indices[i]>() && (repeats[i] > 0)> ?
-                        product_of_elements<r_indices[i]>(R) * repeats[i] : 0
-                        ) + ...);
-                }(std::make_index_sequence<kronecker_indices.size()>());
-                result += g3 * kronecker_product_term;
+        // A term of one element of a derivative of a radial potential:
+        // coefficient * g_order(r) * R_x^exponents[0] * R_y^exponents[1] * R_z^exponents[2]
+        struct DerivativeTerm {
+            double coefficient;
+            std::size_t order;
+            std::array<std::size_t, 3> exponents;
+        };
+
+        // The terms of the element of the N-th derivative with Nx, Ny and Nz indices along each axis.
+        //
+        // The derivative is a sum over every way of pairing up k of its indices into Kronecker deltas,
+        // with the remaining N - 2k indices each contributing a coordinate of R, and g_{N - k}(r) as the radial factor.
+        // A delta vanishes unless both of its indices are along the same axis, so for a single element
+        // the surviving pairings can be counted axis by axis, rather than enumerated with binomial_partitions():
+        // 2p of the n indices along an axis are chosen in C(n, 2p) ways, and paired up in (2p - 1)!! ways.
+        template<std::size_t Nx, std::size_t Ny, std::size_t Nz>
+        consteval auto derivativeTerms() {
+            constexpr std::array<std::size_t, 3> counts{Nx, Ny, Nz};
+            std::array<DerivativeTerm, (Nx / 2 + 1) * (Ny / 2 + 1) * (Nz / 2 + 1)> terms{};
+            std::size_t t = 0;
+            for (std::size_t px = 0; 2 * px <= Nx; ++px) {
+                for (std::size_t py = 0; 2 * py <= Ny; ++py) {
+                    for (std::size_t pz = 0; 2 * pz <= Nz; ++pz) {
+                        const std::array<std::size_t, 3> pairs{px, py, pz};
+                        auto &term = terms[t++];
+                        term.coefficient = 1.0;
+                        term.order = Nx + Ny + Nz;
+                        for (std::size_t d = 0; d < 3; ++d) {
+                            term.coefficient *= static_cast<double>(
+                                    n_choose_k(counts[d], 2 * pairs[d]) *
+                                    double_factorial(2 * static_cast<std::ptrdiff_t>(pairs[d]) - 1)
+                            );
+                            term.order -= pairs[d];
+                            term.exponents[d] = counts[d] - 2 * pairs[d];
+                        }
+                    }
+                }
             }
+            return terms;
+        }
 
-            return result;
-        } else if constexpr (N == 5) {
-            auto result = g5 * cartesian_product_term;
-            return result;
+        // Number of indices along an axis
+        template<auto index>
+        consteval std::size_t countOf(std::size_t axis) {
+            std::size_t count = 0;
+            for (auto i: index) count += static_cast<std::size_t>(i) == axis;
+            return count;
         }
-        return 0.0f;
+
+    }
+
+    /**
+     * @brief Radial factors of the derivatives of a radial potential, 1 / r by default
+     *
+     * \f$ g_m = (\frac{1}{r} \frac{d}{dr})^m \phi \f$, which satisfy \f$ \partial_i g_m = g_{m + 1} R_i \f$;
+     * for 1 / r, \f$ g_m(r) = (-1)^m (2m - 1)!! / r^{2m + 1} \f$.
+     *
+     * @tparam N the highest factor needed
+     * @param R the separation vector
+     * @param potential the potential, see radial::radial_potential
+     * @return the factors \f$ g_0 \f$ through \f$ g_N \f$
+     */
+    template<std::size_t N, indexable Vector,
+            radial::radial_potential<scalar_of<Vector>> Potential = radial::Newtonian>
+    ALWAYS_INLINE auto radial_factors(const Vector &R, const Potential &potential = {}) {
+        return potential.template factors<N>(squared_length(R));
     }
 
+    /**
+     * @brief Powers of each coordinate of a vector
+     *
+     * @tparam N the highest power needed
+     * @param R the vector
+     * @return an array holding \f$ R_d^0 \f$ through \f$ R_d^N \f$ for each axis d
+     */
     template<std::size_t N, indexable Vector>
-    ALWAYS_INLINE auto derivative(const Vector &R) {
-        return SymmetricTensor3f<N>::NullaryExpression([&]<auto index>()  LAMBDA_ALWAYS_INLINE {
-                return derivative_at<index, N>(R);
-        });
+    ALWAYS_INLINE auto coordinate_powers(const Vector &R) {
+        using Scalar = scalar_of<Vector>;
+        std::array<std::array<Scalar, N + 1>, 3> powers{};
+        for (std::size_t d = 0; d < 3; ++d) {
+            powers[d][0] = Scalar{1};
+            for (std::size_t e = 1; e <= N; ++e)
+                powers[d][e] = powers[d][e - 1] * R[d];
+        }
+        return powers;
+    }
+
+    /**
+     * @brief A single element of the N-th derivative of a radial potential, from precomputed factors
+     *
+     * @tparam index the indices of the element
+     * @param g the radial factors, see radial_factors()
+     * @param powers the powers of each coordinate, see coordinate_powers()
+     */
+    template<auto index, typename RadialFactors, typename Powers>
+    ALWAYS_INLINE auto derivative_element(const RadialFactors &g, const Powers &powers) {
+        using Scalar = typename RadialFactors::value_type;
+        constexpr auto terms = derivativeTerms<countOf<index>(0), countOf<index>(1), countOf<index>(2)>();
+        return [&]<std::size_t... t>(std::index_sequence<t...>) LAMBDA_ALWAYS_INLINE {
+            return ((scalar_cast<Scalar>(terms[t].coefficient) * g[terms[t].order] *
+                     powers[0][terms[t].exponents[0]] *
+                     powers[1][terms[t].exponents[1]] *
+                     powers[2][terms[t].exponents[2]]) + ...);
+        }(std::make_index_sequence<terms.size()>());
+    }
+
+    /**
+     * @brief A single element of the N-th derivative of a radial potential, 1 / |R| by default
+     *
+     * @tparam index the indices of the element
+     * @tparam N the order of the derivative, which must match the number of indices
+     * @param R the separation vector
+     * @param potential the potential, see radial::radial_potential
+     */
+    template<auto index, std::size_t N, indexable Vector,
+            radial::radial_potential<scalar_of<Vector>> Potential = radial::Newtonian>
+    ALWAYS_INLINE auto derivative_at(const Vector &R, const Potential &potential = {}) {
+        static_assert(index.size() == N);
+        return derivative_element<index>(radial_factors<N>(R, potential), coordinate_powers<N>(R));
+    }
+
+    /**
+     * @brief The N-th derivative of a radial potential, from precomputed factors
+     *
+     * @tparam N the order of the derivative
+     * @param g the radial factors, up to at least \f$ g_N \f$, see radial_factors()
+     * @param powers the powers of each coordinate, up to at least N, see coordinate_powers()
+     * @return a symmetric tensor of rank N
+     */
+    template<std::size_t N, typename RadialFactors, typename Powers>
+    ALWAYS_INLINE auto derivative(const RadialFactors &g, const Powers &powers) {
+        // Every element is unrolled, even above SYMTENSOR_UNROLL_THRESHOLD, so that its terms are known at compile-time
+        return SymmetricTensor<typename RadialFactors::value_type, 3, N>::NullaryExpression(
+                [&]<auto index>() LAMBDA_ALWAYS_INLINE {
+                    return derivative_element<index>(g, powers);
+                }
+        );
+    }
+
+    /**
+     * @brief The N-th derivative of a radial potential, 1 / |R| by default, for any order N
+     *
+     * Every element is a sum of products of a radial factor and powers of the coordinates,
+     * whose coefficients are found at compile-time (see derivativeTerms).
+     * The radial factors and powers are computed once, and shared by every element.
+     * Only the radial factors depend on the potential.
+     *
+     * @tparam N the order of the derivative
+     * @param R the separation vector
+     * @param potential the potential, see radial::radial_potential
+     * @return a symmetric tensor of rank N
+     */
+    template<std::size_t N, indexable Vector,
+            radial::radial_potential<scalar_of<Vector>> Potential = radial::Newtonian>
+    ALWAYS_INLINE auto derivative(const Vector &R, const Potential &potential = {}) {
+        return derivative<N>(radial_factors<N>(R, potential), coordinate_powers<N>(R));
     };
 
-    template<std::size_t N, indexable Vector>
-    ALWAYS_INLINE auto derivatives(const Vector &R) {
+    /**
+     * @brief Every derivative from the first to the N-th, from precomputed factors
+     *
+     * @tparam N the order of the highest derivative
+     * @param g the radial factors, up to at least \f$ g_N \f$, see radial_factors()
+     * @param powers the powers of each coordinate, up to at least N, see coordinate_powers()
+     * @return a multipole holding the derivative of each rank, from 1 to N
+     */
+    template<std::size_t N, typename RadialFactors, typename Powers>
+    ALWAYS_INLINE auto derivatives(const RadialFactors &g, const Powers &powers) {
         return [&]<auto... i>(std::index_sequence<i...>) LAMBDA_ALWAYS_INLINE {
-                //                        return Multipole3f<N>(derivative<i + 1>(R) ...);
-                return std::make_tuple(derivative<i + 1>(R) ...);
+            return Multipole<N, SymmetricTensor<typename RadialFactors::value_type, 3, 1>>{
+                    derivative<i + 1>(g, powers)...
+            };
         }(std::make_index_sequence<N>());
+    }
+
+    /**
+     * @brief Every derivative of a radial potential, 1 / |R| by default, from the first to the N-th
+     *
+     * The radial factors and the powers of the coordinates are computed once, for the highest order,
+     * and shared by the tensors of every rank; so for 1 / |R| only a single square root and division are needed.
+     *
+     * @tparam N the order of the highest derivative
+     * @param R the separation vector
+     * @param potential the potential, see radial::radial_potential
+     * @return a multipole holding the derivative of each rank, from 1 to N
+     */
+    template<std::size_t N, indexable Vector,
+            radial::radial_potential<scalar_of<Vector>> Potential = radial::Newtonian>
+    ALWAYS_INLINE auto derivatives(const Vector &R, const Potential &potential = {}) {
+        return derivatives<N>(radial_factors<N>(R, potential), coordinate_powers<N>(R));
     };
 
 
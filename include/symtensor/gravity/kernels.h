@@ -0,0 +1,213 @@
+#pragma once
+
+#include <algorithm>
+#include <experimental/simd>
+#include <span>
+#include <tuple>
+#include <type_traits>
+
+#include <glm/vec3.hpp>
+
+#include "symtensor/symtensor.h"
+#include "symtensor/util.h"
+#include "symtensor/MultipoleMoment.h"
+#include "symtensor/LocalExpansion.h"
+
+#include "direct.h"
+#include "einsum.h"
+#include "tensorlib.h"
+#include "softened.h"
+
+namespace symtensor::gravity {
+
+    // Tags which select the implementation of the gravity derivatives used by a kernel.
+    // Each provides derivatives<N>(R), a tuple of the derivatives of 1 / |R| of ranks 1 through N,
+    // computed in the scalar type of R.
+
+    struct Direct {
+        static constexpr std::size_t MaxOrder = 5;
+
+        template<std::size_t N, indexable Vector>
+        ALWAYS_INLINE static auto derivatives(const Vector &R) { return direct::derivatives<N>(R); }
+    };
+
+    struct Einsum {
+        static constexpr std::size_t MaxOrder = 10;
+
+        template<std::size_t N, indexable Vector>
+        ALWAYS_INLINE static auto derivatives(const Vector &R) { return einsum::derivatives<N>(R).underlying_tuple(); }
+    };
+
+    struct Tensorlib {
+        static constexpr std::size_t MaxOrder = tensorlib::MaxOrder;
+
+        template<std::size_t N, indexable Vector>
+        ALWAYS_INLINE static auto derivatives(const Vector &R) { return tensorlib::derivatives<N>(R).underlying_tuple(); }
+    };
+
+    namespace {
+
+        // The counterpart of a scalar type with Compute elements: vector scalars keep their number of lanes
+        template<typename Compute, typename Storage>
+        struct widened {
+            static_assert(std::is_arithmetic_v<Storage>,
+                          "MixedPrecision needs an arithmetic scalar, or a std::experimental::simd whose lanes "
+                          "can be rebound to Compute");
+            using type = Compute;
+        };
+
+        template<typename Compute, typename T, typename Abi>
+        struct widened<Compute, std::experimental::simd<T, Abi>> {
+            using type = std::experimental::rebind_simd_t<Compute, std::experimental::simd<T, Abi>>;
+        };
+
+    }
+
+    /**
+     * @brief Mixed-precision policy, which runs another backend in a wider scalar type
+     *
+     * Each backend computes in the scalar type of the separation vector it is given.
+     * The radial factors \f$ g_n \propto r^{-(2n + 1)} \f$ leave the range of single precision
+     * at far milder separations than the derivatives themselves, so this policy computes r, the radial factors
+     * and every derivative in Compute, and only rounds the finished tensors to the scalar type of the separation.
+     * e.g. `multipoleToLocal<MixedPrecision<Einsum>>(...)` stores float tensors which were computed in double.
+     * A simd separation is computed in a simd of Compute with the same number of lanes.
+     *
+     * @tparam Backend implementation of the gravity derivatives, see Direct, Einsum and Tensorlib
+     * @tparam Compute the scalar type used for the computation
+     */
+    template<typename Backend, typename Compute = double>
+    struct MixedPrecision {
+        static constexpr std::size_t MaxOrder = Backend::MaxOrder;
+
+        template<std::size_t N, indexable Vector>
+        ALWAYS_INLINE static auto derivatives(const Vector &R) {
+            using Storage = scalar_of<Vector>;
+            using Wide = typename widened<Compute, Storage>::type;
+            const SymmetricTensor<Wide, 3, 1> wide{
+                    scalar_cast<Wide>(R[0]), scalar_cast<Wide>(R[1]), scalar_cast<Wide>(R[2])
+            };
+            return std::apply([](const auto &...tensors) LAMBDA_ALWAYS_INLINE {
+                return std::make_tuple(rounded<Storage>(tensors)...);
+            }, Backend::template derivatives<N>(wide));
+        }
+
+    private:
+
+        template<typename Storage, typename Tensor>
+        ALWAYS_INLINE static auto rounded(const Tensor &tensor) {
+            SymmetricTensor<Storage, Tensor::Dimensions, Tensor::Rank> result{};
+            for (std::size_t i = 0; i < Tensor::NumUniqueValues; ++i)
+                result[i] = scalar_cast<Storage>(tensor[i]);
+            return result;
+        }
+    };
+
+    /**
+     * @brief Multipole-to-local (M2L) kernel
+     *
+     * Accumulates the Taylor expansion of \f$ \sum_i m_i / |y - x_i| \f$ about a target center
+     * due to the masses summarized by a multipole moment about a source center:
+     * \f[ L_n \mathrel{+}= \sum_{m=0}^{P} \frac{(-1)^m}{m!} D_{n + m}(R) \cdot M_m \f]
+     * where \f$ D_k \f$ is the k-th derivative of \f$ 1 / |R| \f$.
+     * The first-order tensor of the local expansion is then the acceleration at the target center,
+     * and the scalar is the negated potential.
+     *
+     * Only the terms allowed by the orders of the two expansions are computed,
+     * so derivatives are produced up to rank P + Q, and no higher.
+     *
+     * @tparam Backend implementation of the gravity derivatives, see Direct, Einsum, Tensorlib and MixedPrecision
+     *
+     * @param local expansion about the target center, of order Q, to accumulate into
+     * @param moment multipole moment of order P about the source center
+     *  (not normalized, with the tensor of each rank holding the mass-weighted powers of the positions)
+     * @param separation the target center minus the source center
+     * @return the modified local expansion
+     */
+    template<typename Backend = Direct, typename Local, typename Moment, indexable Vector>
+    inline Local &multipoleToLocal(Local &local, const Moment &moment, const Vector &separation) {
+        constexpr std::size_t P = Moment::Order;
+        constexpr std::size_t Q = Local::Order;
+        static_assert(P + Q <= Backend::MaxOrder,
+                      "The derivative backend does not support the orders of these expansions");
+        using Scalar = scalar_of<Vector>;
+        using std::sqrt;
+
+        const auto derivatives = Backend::template derivatives<P + Q>(separation);
+        const Scalar inverseDistance = Scalar{1} / sqrt(squared_length(separation));
+
+        // Adds the contribution of the rank-m moment to the rank-n tensor of the local expansion
+        auto addTerm = [&]<std::size_t n, std::size_t m>() LAMBDA_ALWAYS_INLINE {
+            const Scalar coefficient = scalar_cast<Scalar>((m % 2 ? -1.0 : 1.0) / static_cast<double>(factorial(m)));
+            if constexpr (n == 0 && m == 0)
+                local.scalar() += inverseDistance * moment.scalar();
+            else if constexpr (m == 0)
+                local.template tensor<n>() += std::get<n - 1>(derivatives) * moment.scalar();
+            else if constexpr (n == 0)
+                local.scalar() += (std::get<m - 1>(derivatives) * moment.template tensor<m>()) * coefficient;
+            else
+                local.template tensor<n>() += (std::get<n + m - 1>(derivatives) * moment.template tensor<m>()) * coefficient;
+        };
+        auto addRank = [&]<std::size_t n>() LAMBDA_ALWAYS_INLINE {
+            [&]<std::size_t... m>(std::index_sequence<m...>) LAMBDA_ALWAYS_INLINE {
+                (addTerm.template operator()<n, m>(), ...);
+            }(std::make_index_sequence<P + 1>());
+        };
+        [&]<std::size_t... n>(std::index_sequence<n...>) LAMBDA_ALWAYS_INLINE {
+            (addRank.template operator()<n>(), ...);
+        }(std::make_index_sequence<Q + 1>());
+
+        return local;
+    }
+
+    /**
+     * @brief Particle-to-particle (P2P) kernel
+     *
+     * Accumulates the acceleration \f$ \sum_j m_j (x_j - x_i) / |x_j - x_i|^3 \f$
+     * and the field (negated potential) \f$ \sum_j m_j / |x_j - x_i| \f$ at each target due to every source.
+     * Pairs at zero separation are skipped, so a set of particles may be passed as its own sources.
+     *
+     * Targets are loaded into the lanes of a native SIMD vector, and every source is broadcast across them.
+     *
+     * @param targets positions at which the field is evaluated
+     * @param accelerations the acceleration at each target is added to the corresponding vector
+     * @param fields the field at each target is added to the corresponding scalar
+     * @param sources positions of the source particles
+     * @param masses mass of each source particle
+     */
+    inline void particleToParticle(std::span<const glm::vec3> targets,
+                                   std::span<glm::vec3> accelerations, std::span<float> fields,
+                                   std::span<const glm::vec3> sources, std::span<const float> masses) {
+        using Lanes = std::experimental::native_simd<float>;
+        constexpr std::size_t Width = Lanes::size();
+
+        for (std::size_t start = 0; start < targets.size(); start += Width) {
+            const std::size_t count = std::min(Width, targets.size() - start);
+
+            // Unused lanes of the final block are left at the origin
+            auto coordinate = [&](int d) {
+                return Lanes{[&](auto l) { return l < count ? targets[start + l][d] : 0.0f; }};
+            };
+            const Lanes x = coordinate(0), y = coordinate(1), z = coordinate(2);
+
+            Lanes ax{0}, ay{0}, az{0}, field{0};
+            for (std::size_t j = 0; j < sources.size(); ++j) {
+                const Lanes dx = sources[j].x - x, dy = sources[j].y - y, dz = sources[j].z - z;
+                const Lanes r2 = dx * dx + dy * dy + dz * dz;
+                Lanes inverseDistance = 1.0f / std::experimental::sqrt(r2);
+                where(r2 == 0.0f, inverseDistance) = 0.0f;
+                const Lanes scale = masses[j] * inverseDistance * inverseDistance * inverseDistance;
+                ax += dx * scale;
+                ay += dy * scale;
+                az += dz * scale;
+                field += masses[j] * inverseDistance;
+            }
+
+            for (std::size_t l = 0; l < count; ++l) {
+                accelerations[start + l] += glm::vec3{ax[l], ay[l], az[l]};
+                fields[start + l] += field[l];
+            }
+        }
+    }
+
+}
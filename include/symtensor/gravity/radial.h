@@ -0,0 +1,140 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <concepts>
+#include <numbers>
+
+#include "symtensor/util.h"
+
+namespace symtensor::gravity::radial {
+
+    /**
+     * @brief A radial potential \f$ \phi(r) \f$, described by the radial factors of its derivatives
+     *
+     * The N-th derivative of any radial potential is a sum over the ways of pairing up its indices into
+     * Kronecker deltas, each weighted by a power of the coordinates and a radial factor
+     * \f$ g_m = (\frac{1}{r} \frac{d}{dr})^m \phi \f$, exactly as for 1 / r (see einsum::derivative()).
+     * A potential provides `factors<N>(r2)`: the factors \f$ g_0 \f$ (the potential) through \f$ g_N \f$,
+     * as a function of the squared distance. The tensors themselves are assembled by einsum or tensorlib.
+     */
+    template<typename Potential, typename Scalar>
+    concept radial_potential = requires(const Potential &potential, const Scalar &r2) {
+        { potential.template factors<2>(r2) } -> std::same_as<std::array<Scalar, 3>>;
+    };
+
+    /// The Newtonian potential 1 / r, where \f$ g_m = (-1)^m (2m - 1)!! / r^{2m + 1} \f$
+    struct Newtonian {
+
+        template<std::size_t N, typename Scalar>
+        ALWAYS_INLINE std::array<Scalar, N + 1> factors(const Scalar &r2) const {
+            using std::sqrt;
+            const Scalar inv_r2 = Scalar{1} / r2;
+            std::array<Scalar, N + 1> g{};
+            g[0] = Scalar{1} / sqrt(r2);
+            [&]<std::size_t... m>(std::index_sequence<m...>) LAMBDA_ALWAYS_INLINE {
+                ((g[m + 1] = scalar_cast<Scalar>(-(2.0 * m + 1.0)) * g[m] * inv_r2), ...);
+            }(std::make_index_sequence<N>());
+            return g;
+        }
+    };
+
+    /**
+     * @brief The Yukawa (or screened Coulomb) potential \f$ e^{-\kappa r} / r \f$
+     *
+     * The factors follow \f$ g_m = (-(2m - 1) g_{m - 1} + \kappa^2 g_{m - 2}) / r^2 \f$,
+     * which are those of 1 / r for \f$ \kappa = 0 \f$.
+     * For Debye screening, \f$ \kappa \f$ is the inverse of the Debye length.
+     *
+     * @tparam T the type of the parameter, which may be a vector scalar to give each lane its own range
+     */
+    template<typename T>
+    struct Yukawa {
+        /// The inverse range of the potential
+        T kappa;
+
+        template<std::size_t N, typename Scalar>
+        ALWAYS_INLINE std::array<Scalar, N + 1> factors(const Scalar &r2) const {
+            using std::sqrt, std::exp;
+            const Scalar k = scalar_cast<Scalar>(kappa);
+            const Scalar k2 = k * k;
+            const Scalar r = sqrt(r2);
+            const Scalar inv_r2 = Scalar{1} / r2;
+            std::array<Scalar, N + 1> g{};
+            g[0] = exp(-k * r) / r;
+            if constexpr (N >= 1)
+                g[1] = -(Scalar{1} + k * r) * g[0] * inv_r2;
+            [&]<std::size_t... m>(std::index_sequence<m...>) LAMBDA_ALWAYS_INLINE {
+                ((g[m + 2] = (scalar_cast<Scalar>(-(2.0 * m + 3.0)) * g[m + 1] + k2 * g[m]) * inv_r2), ...);
+            }(std::make_index_sequence<N >= 1 ? N - 1 : 0>());
+            return g;
+        }
+    };
+
+    /**
+     * @brief The short-range part \f$ \mathrm{erfc}(\alpha r) / r \f$ of an Ewald or P3M split of 1 / r
+     *
+     * The factors follow
+     * \f$ g_m = (-(2m - 1) g_{m - 1} + (-2 \alpha^2)^m e^{-\alpha^2 r^2} / (\alpha \sqrt{\pi})) / r^2 \f$.
+     *
+     * @tparam T the type of the parameter, which may be a vector scalar to give each lane its own split
+     */
+    template<typename T>
+    struct ShortRange {
+        /// The inverse of the splitting length
+        T alpha;
+
+        template<std::size_t N, typename Scalar>
+        ALWAYS_INLINE std::array<Scalar, N + 1> factors(const Scalar &r2) const {
+            using std::sqrt, std::exp, std::erfc;
+            const Scalar a = scalar_cast<Scalar>(alpha);
+            const Scalar r = sqrt(r2);
+            const Scalar inv_r2 = Scalar{1} / r2;
+            const Scalar minus_2a2 = scalar_cast<Scalar>(-2.0) * a * a;
+
+            // The Gaussian term, which gains a factor of -2 alpha^2 with each order
+            Scalar gaussian = scalar_cast<Scalar>(std::numbers::inv_sqrtpi) * exp(-a * a * r2) / a;
+            std::array<Scalar, N + 1> g{};
+            g[0] = erfc(a * r) / r;
+            [&]<std::size_t... m>(std::index_sequence<m...>) LAMBDA_ALWAYS_INLINE {
+                ((gaussian *= minus_2a2,
+                        g[m + 1] = (scalar_cast<Scalar>(-(2.0 * m + 1.0)) * g[m] + gaussian) * inv_r2), ...);
+            }(std::make_index_sequence<N>());
+            return g;
+        }
+    };
+
+    /**
+     * @brief The long-range part \f$ \mathrm{erf}(\alpha r) / r \f$ of an Ewald or P3M split of 1 / r
+     *
+     * The complement of ShortRange, whose Gaussian term enters with the opposite sign.
+     * The potential is smooth at the origin, but the factors are formed by a recurrence in 1 / r,
+     * which loses precision to cancellation where \f$ \alpha r \ll 1 \f$.
+     *
+     * @tparam T the type of the parameter, which may be a vector scalar to give each lane its own split
+     */
+    template<typename T>
+    struct LongRange {
+        /// The inverse of the splitting length
+        T alpha;
+
+        template<std::size_t N, typename Scalar>
+        ALWAYS_INLINE std::array<Scalar, N + 1> factors(const Scalar &r2) const {
+            using std::sqrt, std::exp, std::erf;
+            const Scalar a = scalar_cast<Scalar>(alpha);
+            const Scalar r = sqrt(r2);
+            const Scalar inv_r2 = Scalar{1} / r2;
+            const Scalar minus_2a2 = scalar_cast<Scalar>(-2.0) * a * a;
+
+            Scalar gaussian = scalar_cast<Scalar>(std::numbers::inv_sqrtpi) * exp(-a * a * r2) / a;
+            std::array<Scalar, N + 1> g{};
+            g[0] = erf(a * r) / r;
+            [&]<std::size_t... m>(std::index_sequence<m...>) LAMBDA_ALWAYS_INLINE {
+                ((gaussian *= minus_2a2,
+                        g[m + 1] = (scalar_cast<Scalar>(-(2.0 * m + 1.0)) * g[m] - gaussian) * inv_r2), ...);
+            }(std::make_index_sequence<N>());
+            return g;
+        }
+    };
+
+}
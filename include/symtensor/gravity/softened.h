@@ -0,0 +1,180 @@
+#pragma once
+
+#include "symtensor/symtensor.h"
+#include "symtensor/util.h"
+
+#include "einsum.h"
+
+namespace symtensor::gravity::radial {
+
+    /**
+     * @brief The Plummer potential \f$ 1 / \sqrt{r^2 + \epsilon^2} \f$
+     *
+     * \f$ g_m = (-1)^m (2m - 1)!! / (r^2 + \epsilon^2)^{m + 1/2} \f$, the Newtonian factors with \f$ r^2 + \epsilon^2 \f$
+     * in place of \f$ r^2 \f$. No branch is needed, but the potential only approaches 1 / r at large separations.
+     *
+     * @tparam T the type of the softening length, which may be a vector scalar
+     */
+    template<typename T>
+    struct Plummer {
+        /// The softening length
+        T epsilon;
+
+        template<std::size_t N, typename Scalar>
+        ALWAYS_INLINE std::array<Scalar, N + 1> factors(const Scalar &r2) const {
+            const Scalar e = scalar_cast<Scalar>(epsilon);
+            return Newtonian{}.factors<N>(r2 + e * e);
+        }
+    };
+
+    namespace {
+
+        // A term coefficient * u^power of the potential, in terms of u = r / h
+        struct SplineTerm {
+            double coefficient;
+            int power;
+        };
+
+        // h times the potential of the cubic spline kernel (Monaghan & Lattanzio 1985), as used by GADGET-2,
+        // for u < 1/2 and for 1/2 <= u < 1. The inner branch is padded with empty terms to the same length.
+        constexpr std::array<SplineTerm, 6> InnerSpline{{
+                {14.0 / 5.0, 0}, {-16.0 / 3.0, 2}, {48.0 / 5.0, 4}, {-32.0 / 5.0, 5}, {0.0, 0}, {0.0, 0}
+        }};
+        constexpr std::array<SplineTerm, 6> OuterSpline{{
+                {-1.0 / 15.0, -1}, {16.0 / 5.0, 0}, {-32.0 / 3.0, 2}, {16.0, 3}, {-48.0 / 5.0, 4}, {32.0 / 15.0, 5}
+        }};
+
+        // The terms of h^(2m + 1) g_m, where each application of (1/r d/dr) takes u^k to k u^(k - 2) / h^2
+        template<std::size_t m, bool Inner>
+        consteval auto splineTerms() {
+            auto terms = Inner ? InnerSpline : OuterSpline;
+            for (auto &term: terms) {
+                for (std::size_t j = 0; j < m; ++j) {
+                    term.coefficient *= term.power;
+                    term.power -= 2;
+                }
+            }
+            return terms;
+        }
+
+        template<std::size_t m, bool Inner, typename Scalar>
+        ALWAYS_INLINE Scalar splineFactor(const Scalar &u, const Scalar &inv_u) {
+            static constexpr auto terms = splineTerms<m, Inner>();
+            return [&]<std::size_t... t>(std::index_sequence<t...>) LAMBDA_ALWAYS_INLINE {
+                return (Scalar{0} + ... + [&]() LAMBDA_ALWAYS_INLINE -> Scalar {
+                    // Vanishing terms are dropped, so negative powers of u are only formed where they're needed
+                    constexpr auto term = terms[t];
+                    if constexpr (term.coefficient == 0.0)
+                        return Scalar{0};
+                    else if constexpr (term.power >= 0)
+                        return scalar_cast<Scalar>(term.coefficient) * symtensor::pow<std::size_t(term.power)>(u);
+                    else
+                        return scalar_cast<Scalar>(term.coefficient) * symtensor::pow<std::size_t(-term.power)>(inv_u);
+                }());
+            }(std::make_index_sequence<terms.size()>());
+        }
+
+    }
+
+    /**
+     * @brief The spline-softened potential
+     *
+     * The potential of a cubic spline mass distribution with support radius h, which is exactly 1 / r beyond h,
+     * and equal to the Plummer potential with \f$ \epsilon = h / 2.8 \f$ at r = 0.
+     * Within h each factor is a polynomial in u = r / h and 1 / u.
+     * Every branch is evaluated and the results are blended with select(),
+     * so that lanes of a vector scalar can fall on different branches.
+     *
+     * Above the second order, the factors within h / 2 diverge as r approaches 0
+     * (while the derivatives remain finite up to the fifth), so R must not vanish.
+     *
+     * @tparam T the type of the softening length, which may be a vector scalar
+     */
+    template<typename T>
+    struct Spline {
+        /// The softening length, beyond which the potential is Newtonian
+        T h;
+
+        template<std::size_t N, typename Scalar>
+        ALWAYS_INLINE std::array<Scalar, N + 1> factors(const Scalar &r2) const {
+            using std::sqrt;
+
+            const Scalar inv_h = Scalar{1} / scalar_cast<Scalar>(h);
+            const Scalar inv_h2 = inv_h * inv_h;
+            const Scalar u = sqrt(r2) * inv_h;
+            const Scalar inv_u = Scalar{1} / u;
+            const auto inner = u < scalar_cast<Scalar>(0.5);
+            const auto softened = u < Scalar{1};
+
+            auto g = Newtonian{}.factors<N>(r2);
+            Scalar scale = inv_h;
+            [&]<std::size_t... m>(std::index_sequence<m...>) LAMBDA_ALWAYS_INLINE {
+                ((g[m] = select(softened, scale * select(inner, splineFactor<m, true>(u, inv_u),
+                                                         splineFactor<m, false>(u, inv_u)), g[m]),
+                        scale *= inv_h2), ...);
+            }(std::make_index_sequence<N + 1>());
+            return g;
+        }
+    };
+
+}
+
+namespace symtensor::gravity::plummer {
+
+    /**
+     * @brief Radial factors of the derivatives of the Plummer potential, see radial::Plummer
+     *
+     * @tparam N the highest factor needed
+     * @param R the separation vector
+     * @param epsilon the softening length
+     * @return the factors \f$ g_0 \f$ through \f$ g_N \f$
+     */
+    template<std::size_t N, indexable Vector>
+    ALWAYS_INLINE auto radial_factors(const Vector &R, const scalar_of<Vector> &epsilon) {
+        return einsum::radial_factors<N>(R, radial::Plummer<scalar_of<Vector>>{epsilon});
+    }
+
+    /**
+     * @brief Every derivative of the Plummer potential from the first to the N-th
+     *
+     * @tparam N the order of the highest derivative
+     * @param R the separation vector
+     * @param epsilon the softening length
+     * @return a multipole holding the derivative of each rank, from 1 to N
+     */
+    template<std::size_t N, indexable Vector>
+    ALWAYS_INLINE auto derivatives(const Vector &R, const scalar_of<Vector> &epsilon) {
+        return einsum::derivatives<N>(R, radial::Plummer<scalar_of<Vector>>{epsilon});
+    }
+
+}
+
+namespace symtensor::gravity::spline {
+
+    /**
+     * @brief Radial factors of the derivatives of the spline-softened potential, see radial::Spline
+     *
+     * @tparam N the highest factor needed
+     * @param R the separation vector
+     * @param h the softening length, beyond which the potential is Newtonian
+     * @return the factors \f$ g_0 \f$ through \f$ g_N \f$
+     */
+    template<std::size_t N, indexable Vector>
+    ALWAYS_INLINE auto radial_factors(const Vector &R, const scalar_of<Vector> &h) {
+        return einsum::radial_factors<N>(R, radial::Spline<scalar_of<Vector>>{h});
+    }
+
+    /**
+     * @brief Every derivative of the spline-softened potential from the first to the N-th
+     *
+     * @tparam N the order of the highest derivative
+     * @param R the separation vector
+     * @param h the softening length, beyond which the potential is Newtonian
+     * @return a multipole holding the derivative of each rank, from 1 to N
+     */
+    template<std::size_t N, indexable Vector>
+    ALWAYS_INLINE auto derivatives(const Vector &R, const scalar_of<Vector> &h) {
+        return einsum::derivatives<N>(R, radial::Spline<scalar_of<Vector>>{h});
+    }
+
+}
@@ -1,45 +1,62 @@
 #pragma once
 
-#define GLM_ENABLE_EXPERIMENTAL
-
-#include <glm/gtx/norm.hpp>
-
 #include "symtensor/symtensor.h"
 #include "symtensor/util.h"
 
-#include "tensorlib_autogen.h"
-#include "symtensor/MultipoleMoment.h"
+#include "radial.h"
+
+// Generated at build time by generator/derivativeKernels.cpp
+#include "symtensor/gravity/derivativeKernels.h"
 
 namespace symtensor::gravity::tensorlib {
 
-    ALWAYS_INLINE auto derivatives5(const glm::vec3 &R) {
-        // todo: Not a fan of this.
-        float d0{};
-        a_3 point{R.x, R.y, R.z};
-        auto d = Multipole3f<5>{};
-        auto &[st1, st2, st3, st4, st5] = d;
-        get_multipole_derivatives(
-                d0,
-                reinterpret_cast<A_3 &>(st1),
-                reinterpret_cast<AA_3 &>(st2),
-                reinterpret_cast<AAA_3 &>(st3),
-                reinterpret_cast<AAAA_3 &>(st4),
-                reinterpret_cast<AAAAA_3 &>(st5),
-                point
-        );
+    /// The highest order of the generated kernels, set by SYMTENSOR_KERNEL_MAX_ORDER
+    inline constexpr std::size_t MaxOrder = generated::MaxOrder;
+
+    /**
+     * @brief The N-th derivative of a radial potential, 1 / |R| by default, using a generated kernel
+     *
+     * Only the elements of rank N are computed.
+     * The kernels take the radial factors of the potential as input, so every potential shares them.
+     * Kernels exist for separations of 2 or 3 dimensions, and the tensor has the dimensions of the separation.
+     *
+     * @tparam N the order of the derivative
+     * @param R the separation vector
+     * @param potential the potential, see radial::radial_potential
+     * @return a symmetric tensor of rank N
+     */
+    template<std::size_t N, indexable Vector,
+            radial::radial_potential<scalar_of<Vector>> Potential = radial::Newtonian>
+    ALWAYS_INLINE auto derivative(const Vector &R, const Potential &potential = {}) {
+        static_assert(N <= MaxOrder, "No kernel was generated for this order, see SYMTENSOR_KERNEL_MAX_ORDER");
+        constexpr std::size_t D = dimensions_of<Vector>;
+        static_assert(D == 2 || D == 3, "Kernels are only generated for 2D and 3D separation vectors");
+        using Scalar = scalar_of<Vector>;
+        SymmetricTensor<Scalar, D, N> d{};
+        const auto g = potential.template factors<N>(squared_length<D>(R));
+        generated::DerivativeKernel<D, N>::template evaluate<Scalar>(R, g, d);
         return d;
-    }
-
-    template<std::size_t N, indexable Vector>
-    ALWAYS_INLINE auto derivative(const Vector &R) {
-        return derivatives5(R).template tensor<N>();
     };
 
-    template<std::size_t N, indexable Vector>
-    ALWAYS_INLINE auto derivatives(const Vector &R) {
-        auto m = Multipole3f<N>{};
-        return [&]<auto... i>(std::index_sequence<i...>) LAMBDA_ALWAYS_INLINE {
-            return Multipole3f<N>(derivative<i + 1>(R) ...);
-        }(std::make_index_sequence<N>());
+    /**
+     * @brief Every derivative of a radial potential, 1 / |R| by default, from the first to the N-th,
+     * using a single generated kernel
+     *
+     * @tparam N the order of the highest derivative
+     * @param R the separation vector
+     * @param potential the potential, see radial::radial_potential
+     * @return a multipole holding the derivative of each rank, from 1 to N
+     */
+    template<std::size_t N, indexable Vector,
+            radial::radial_potential<scalar_of<Vector>> Potential = radial::Newtonian>
+    ALWAYS_INLINE auto derivatives(const Vector &R, const Potential &potential = {}) {
+        static_assert(N <= MaxOrder, "No kernel was generated for this order, see SYMTENSOR_KERNEL_MAX_ORDER");
+        constexpr std::size_t D = dimensions_of<Vector>;
+        static_assert(D == 2 || D == 3, "Kernels are only generated for 2D and 3D separation vectors");
+        using Scalar = scalar_of<Vector>;
+        Multipole<N, SymmetricTensor<Scalar, D, 1>> d{};
+        const auto g = potential.template factors<N>(squared_length<D>(R));
+        generated::DerivativesKernel<D, N>::template evaluate<Scalar>(R, g, d);
+        return d;
     };
 }
@@ -11,3 +11,19 @@
 #endif
 
 #define LAMBDA_ALWAYS_INLINE __attribute__((always_inline))
+
+// Operations over more than this many elements (or terms) use table-driven loops instead of fully unrolled folds.
+// Unrolling gives the best code for small tensors, but compile time and code size explode for high ranks & dimensions.
+#ifndef SYMTENSOR_UNROLL_THRESHOLD
+    #define SYMTENSOR_UNROLL_THRESHOLD 64
+#endif
+
+// Batched operations are spread over the lanes of std::experimental::simd, where the standard library provides it
+#if __has_include(<experimental/simd>)
+    #include <experimental/simd>
+#endif
+#if defined(__cpp_lib_experimental_parallel_simd)
+    #define SYMTENSOR_HAS_SIMD 1
+#else
+    #define SYMTENSOR_HAS_SIMD 0
+#endif
@@ -7,6 +7,8 @@
 
 #include <symtensor/Multipole.h>
 #include <symtensor/SymmetricTensor.h>
+#include <symtensor/SymmetricTensorArray.h>
+#include <symtensor/TracelessSymmetricTensor.h>
 
 /**
  * @dir symtensor
@@ -9,6 +9,7 @@
 #include <type_traits>
 #include <iostream>
 
+#include "platform.h"
 #include "concepts.h"
 
 namespace symtensor {
@@ -37,6 +38,100 @@ namespace symtensor {
             return value * pow<P - 1>(value);
     }
 
+    /**
+     * @brief Converts a value to the scalar type S.
+     *
+     * Vector scalar types (such as std::experimental::simd) refuse to broadcast from types which might lose
+     * precision (e.g. double to simd<float>), so in that case the value is first converted to the element type.
+     * Vectors with a different element type but the same number of lanes are converted lane by lane.
+     */
+    template<typename S, typename T>
+    inline constexpr S scalar_cast(const T &value) {
+        if constexpr (requires { static_cast<S>(value); })
+            return static_cast<S>(value);
+        else if constexpr (requires { static_simd_cast<S>(value); })
+            return static_simd_cast<S>(value);
+        else
+            return S(static_cast<typename S::value_type>(value));
+    }
+
+    /**
+     * @brief Reduces the result of an element comparison to a single bool.
+     *
+     * Comparisons of ordinary scalars already produce a bool.
+     * Comparisons of vector scalars produce a mask, which is reduced with its (ADL-found) all_of().
+     */
+    template<typename T>
+    inline constexpr bool all_lanes(const T &comparison) {
+        if constexpr (std::is_convertible_v<T, bool>)
+            return static_cast<bool>(comparison);
+        else
+            return all_of(comparison);
+    }
+
+    /**
+     * @brief Chooses between two values by the result of an element comparison.
+     *
+     * Ordinary scalars use the conditional operator.
+     * Vector scalars blend their lanes with the (ADL-found) where(), rather than branching.
+     */
+    template<typename Mask, typename T>
+    inline constexpr T select(const Mask &mask, const T &a, const T &b) {
+        if constexpr (std::is_convertible_v<Mask, bool>)
+            return static_cast<bool>(mask) ? a : b;
+        else {
+            T result = b;
+            where(mask, result) = a;
+            return result;
+        }
+    }
+
+    /**
+     * @brief Writes a scalar to a stream.
+     *
+     * Vector scalars without a stream operator are written as their lanes, e.g. <1 2 3 4>.
+     */
+    template<typename T>
+    inline std::ostream &print_scalar(std::ostream &out, const T &value) {
+        if constexpr (requires { out << value; })
+            return out << value;
+        else {
+            out << "<";
+            for (std::size_t i = 0; i < value.size(); ++i)
+                out << (i == 0 ? "" : " ") << value[i];
+            return out << ">";
+        }
+    }
+
+    /**
+     * @brief The element type of an indexable vector, e.g. float for glm::vec3.
+     */
+    template<indexable Vector>
+    using scalar_of = std::remove_cvref_t<decltype(std::declval<const Vector &>()[0])>;
+
+    /**
+     * @brief The number of elements of an indexable vector, e.g. 3 for glm::vec3 or SymmetricTensor3f<1>.
+     */
+    template<indexable Vector>
+    inline constexpr std::size_t dimensions_of = [] {
+        if constexpr (requires { Vector::Dimensions; })
+            return std::size_t{Vector::Dimensions};
+        else if constexpr (tuple_like<Vector>)
+            return std::size_t{std::tuple_size<Vector>::value};
+        else
+            return static_cast<std::size_t>(Vector::length());
+    }();
+
+    /**
+     * @brief Squared length of the first D elements of any indexable vector type.
+     */
+    template<std::size_t D = 3, indexable Vector>
+    inline constexpr scalar_of<Vector> squared_length(const Vector &v) {
+        return [&]<std::size_t... d>(std::index_sequence<d...>) constexpr {
+            return ((v[d] * v[d]) + ...);
+        }(std::make_index_sequence<D>());
+    }
+
     constexpr std::size_t pascal(std::size_t x, std::size_t y) {
         if (x == 0 || y == 0) return 1;
         else return pascal(x - 1, y) + pascal(x, y - 1);
@@ -47,12 +142,23 @@ namespace symtensor {
         return n * factorial(n - 1);
     }
 
+    /**
+     * @brief Product of every positive integer up to n with the same parity as n
+     *
+     * @param n the (typically odd) integer, where double_factorial(-1) is 1
+     * @return n!!
+     */
+    constexpr std::size_t double_factorial(std::ptrdiff_t n) {
+        if (n <= 0) return 1;
+        return static_cast<std::size_t>(n) * double_factorial(n - 2);
+    }
+
     template<typename T=bool, std::size_t R, typename I>
     static constexpr T kronecker_delta(std::array<I, R> dimensionalIndices) {
-        return std::all_of(
+        return scalar_cast<T>(std::all_of(
                 dimensionalIndices.begin(), dimensionalIndices.end(),
                 [&](auto i) { return i == dimensionalIndices[0]; }
-        );
+        ));
     }
 
     template<auto array>
@@ -143,6 +249,17 @@ namespace symtensor {
         return result;
     }
 
+    /**
+     * @brief Combines several functors into a single overload set
+     *
+     * Useful for providing both compile-time and run-time indexed versions of a function,
+     * e.g. @code{.cpp}overloaded{[]<auto index>() { ... }, [](auto index) { ... }}@endcode.
+     */
+    template<typename... Functions>
+    struct overloaded : Functions ... {
+        using Functions::operator()...;
+    };
+
     template<std::size_t I, typename... T>
     using type_at_index = std::remove_reference_t<decltype(std::get<I>(std::declval<std::tuple<T...>>()))>;
 
@@ -250,7 +367,7 @@ namespace symtensor {
         if (n - k < k) return n_choose_k(n, n - k);
 
         std::size_t result = 1;
-        for (int i = 1; i <= k; ++i) {
+        for (T i = 1; i <= k; ++i) {
             result *= n - i + 1;
             result /= i;
         }
@@ -393,18 +510,52 @@ namespace symtensor {
         return counts;
     }
 
+    /**
+     * @brief Counts the distinct orderings of a multiset
+     *
+     * Equivalent to the multinomial coefficient \f$ N! / \prod_i n_i! \f$,
+     * where \f$ n_i \f$ is the number of times each distinct value appears.
+     * For a symmetric tensor index, this is the number of (lexicographical) indices which share its value.
+     *
+     * @param arr an array of values, which may contain duplicates
+     * @return the number of unique permutations of arr
+     */
     template<typename T, std::size_t N>
     constexpr std::size_t num_unique_permutations(const std::array<T, N> &arr) {
-        const auto counts = countOccurrences(arr);
-        unsigned long long divisor = 1;
+        const auto counts = repeats_table(arr);
+        std::size_t divisor = 1;
         for (std::size_t i = 0; i < N; ++i)
             divisor *= factorial(counts[i]);
         return factorial(N) / divisor;
     }
 
-    template<typename F, typename T, std::size_t N>
-    inline constexpr auto deduplicated_sum(const std::array<T, N> &values, F function = {}) {
-        // todo: This may be very important for good performance!
+    /**
+     * @brief Sums a function over every permutation of each of a set of values,
+     * evaluating the function only once per value.
+     *
+     * For a function which is invariant to the order of its argument (such as an element of a symmetric tensor),
+     * the sum over all permutations of a value is the function's result times @ref num_unique_permutations.
+     * This turns a sum over every lexicographical index of a tensor (\f$ D^R \f$ terms)
+     * into a weighted sum over only its canonical indices.
+     *
+     * @tparam values array of distinct canonical values, e.g. the sorted indices of a symmetric tensor
+     * @param function functor which takes a value as its template parameter,
+     *  e.g. @code{.cpp}[]<auto index>() { return tensor.template at<index>(); }@endcode
+     * @return the sum of the function over every permutation of every value
+     */
+    template<auto values, typename F>
+    ALWAYS_INLINE constexpr auto deduplicated_sum(F function = {}) {
+        static_assert(values.size() > 0);
+        using Result = decltype(function.template operator()<values[0]>());
+        return [&]<std::size_t... i>(std::index_sequence<i...>) LAMBDA_ALWAYS_INLINE {
+            return ([&]() LAMBDA_ALWAYS_INLINE -> Result {
+                constexpr std::size_t weight = num_unique_permutations(values[i]);
+                if constexpr (weight == 1)
+                    return function.template operator()<values[i]>();
+                else
+                    return function.template operator()<values[i]>() * scalar_cast<Result>(weight);
+            }() + ...);
+        }(std::make_index_sequence<values.size()>());
     }
 
 }
@@ -0,0 +1,325 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <numeric>
+#include <random>
+#include <tuple>
+
+#include <glm/vec3.hpp>
+#include <glm/geometric.hpp>
+
+#include <symtensor/fmm/BarnesHut.h>
+#include <symtensor/fmm/Morton.h>
+#include <symtensor/fmm/Scheduler.h>
+#include <symtensor/fmm/Solver.h>
+
+using namespace symtensor;
+
+namespace {
+
+    struct Particles {
+        std::vector<glm::vec3> positions;
+        std::vector<float> masses;
+    };
+
+    // A uniform background with a dense cluster, so that the tree is uneven
+    Particles clusteredParticles(std::size_t count) {
+        std::mt19937 generator{0u};
+        std::uniform_real_distribution<float> uniform{-1.0f, 1.0f};
+        std::normal_distribution<float> cluster{0.0f, 0.05f};
+        std::uniform_real_distribution<float> mass{0.1f, 1.0f};
+        Particles particles;
+        for (std::size_t i = 0; i < count; ++i) {
+            if (i % 3 == 0)
+                particles.positions.emplace_back(0.5f + cluster(generator), cluster(generator), cluster(generator));
+            else
+                particles.positions.emplace_back(uniform(generator), uniform(generator), uniform(generator));
+            particles.masses.push_back(mass(generator));
+        }
+        return particles;
+    }
+
+    void directSum(const Particles &particles, std::span<glm::vec3> accelerations, std::span<float> potentials) {
+        for (std::size_t i = 0; i < particles.positions.size(); ++i) {
+            accelerations[i] = glm::vec3{0};
+            potentials[i] = 0;
+            for (std::size_t j = 0; j < particles.positions.size(); ++j) {
+                if (i == j) continue;
+                auto R = particles.positions[j] - particles.positions[i];
+                float r = glm::length(R);
+                accelerations[i] += R * (particles.masses[j] / (r * r * r));
+                potentials[i] -= particles.masses[j] / r;
+            }
+        }
+    }
+
+    // Median and maximum relative error of the accelerations
+    std::pair<float, float> accelerationErrors(std::span<const glm::vec3> approximate, std::span<const glm::vec3> exact) {
+        std::vector<float> errors;
+        for (std::size_t i = 0; i < exact.size(); ++i)
+            errors.push_back(glm::length(approximate[i] - exact[i]) / glm::length(exact[i]));
+        std::sort(errors.begin(), errors.end());
+        return {errors[errors.size() / 2], errors.back()};
+    }
+
+}
+
+TEST_CASE("Morton keys", "[FMM]") {
+
+    // Bits of each coordinate are interleaved, starting from x
+    REQUIRE(fmm::mortonKey({1, 0, 0}) == 0b001);
+    REQUIRE(fmm::mortonKey({0, 1, 0}) == 0b010);
+    REQUIRE(fmm::mortonKey({0, 0, 1}) == 0b100);
+    REQUIRE(fmm::mortonKey({3, 2, 1}) == 0b011101);
+    constexpr std::uint32_t last = (1u << fmm::MortonBitsPerDimension) - 1;
+    REQUIRE(fmm::mortonKey({last, last, last}) == (std::uint64_t{1} << 63) - 1);
+
+    // Positions are clamped to the cube
+    REQUIRE(fmm::mortonKey(glm::vec3{2.0f}, glm::vec3{0.0f}, (1u << fmm::MortonBitsPerDimension) / 1.0f) ==
+            fmm::mortonKey({last, last, last}));
+    REQUIRE(fmm::mortonKey(glm::vec3{-1.0f}, glm::vec3{0.0f}, 1.0f) == 0);
+}
+
+TEST_CASE("Radix sort", "[FMM]") {
+
+    std::size_t n = GENERATE(0, 1, 1000, 100'000);
+    std::mt19937_64 generator{0u};
+    std::uniform_int_distribution<std::uint64_t> distribution{0, (std::uint64_t{1} << 63) - 1};
+    std::vector<std::uint64_t> keys(n);
+    for (auto &key: keys) key = distribution(generator) & (n % 2 ? ~std::uint64_t{0} : 0xffff00ffff);
+    std::vector<std::size_t> values(n);
+    std::iota(values.begin(), values.end(), std::size_t{0});
+
+    auto original = keys;
+    fmm::Scheduler scheduler{4};
+    fmm::radixSort(keys, values, scheduler);
+
+    // The sort is stable, so it agrees with std::stable_sort on the values as well
+    std::vector<std::size_t> expected(n);
+    std::iota(expected.begin(), expected.end(), std::size_t{0});
+    std::stable_sort(expected.begin(), expected.end(), [&](auto a, auto b) { return original[a] < original[b]; });
+    REQUIRE(values == expected);
+    for (std::size_t i = 0; i < n; ++i)
+        REQUIRE(keys[i] == original[values[i]]);
+}
+
+TEST_CASE("Octree construction", "[FMM]") {
+
+    auto particles = clusteredParticles(1000);
+    fmm::Octree tree{particles.positions, 16};
+
+    // Every particle appears exactly once
+    auto order = tree.order();
+    std::sort(order.begin(), order.end());
+    for (std::size_t i = 0; i < order.size(); ++i)
+        REQUIRE(order[i] == i);
+
+    for (const auto &node: tree.nodes()) {
+        if (node.isLeaf()) {
+            REQUIRE(node.size() <= 16);
+        } else {
+            // Children partition the particles of their parent
+            auto children = tree.children(node);
+            REQUIRE(children.front().begin == node.begin);
+            REQUIRE(children.back().end == node.end);
+            for (std::size_t c = 1; c < children.size(); ++c)
+                REQUIRE(children[c].begin == children[c - 1].end);
+        }
+
+        // Every particle is inside its node
+        for (std::size_t i = node.begin; i < node.end; ++i) {
+            auto offset = particles.positions[tree.order()[i]] - node.center;
+            REQUIRE(std::max({std::abs(offset.x), std::abs(offset.y), std::abs(offset.z)}) <=
+                    node.halfWidth * 1.0001f);
+        }
+    }
+
+    // Particles are sorted by Morton key, and every node holds a single run of key prefixes:
+    // the keys of a node at level L share their first L octant digits, which extend the digits of its parent
+    REQUIRE(std::is_sorted(tree.keys().begin(), tree.keys().end()));
+    const auto &nodes = tree.nodes();
+    const auto prefix = [&](std::size_t i, std::size_t level) {
+        return tree.keys()[i] >> (3 * (fmm::MortonBitsPerDimension - level));
+    };
+    std::vector<std::size_t> levels(nodes.size(), 0);
+    for (std::size_t n = 0; n < nodes.size(); ++n) {
+        const auto &node = nodes[n];
+        REQUIRE(prefix(node.begin, levels[n]) == prefix(node.end - 1, levels[n]));
+        for (std::size_t c = node.firstChild; c < node.firstChild + node.numChildren; ++c) {
+            levels[c] = levels[n] + 1;
+            REQUIRE(nodes[c].halfWidth == node.halfWidth / 2);
+            REQUIRE(prefix(nodes[c].begin, levels[c]) >> 3 == prefix(node.begin, levels[n]));
+        }
+    }
+
+    SECTION("Coincident particles") {
+        std::vector<glm::vec3> positions(100, glm::vec3{1.0f, 2.0f, 3.0f});
+        fmm::Octree coincident{positions, 16};
+        REQUIRE(coincident.nodes().size() == 1);
+        REQUIRE(coincident.root().size() == 100);
+    }
+
+    SECTION("Empty") {
+        fmm::Octree empty{std::span<const glm::vec3>{}, 16};
+        REQUIRE(empty.nodes().size() == 1);
+        REQUIRE(empty.root().isLeaf());
+    }
+}
+
+TEST_CASE("Fast multipole method accuracy", "[FMM]") {
+
+    auto particles = clusteredParticles(2000);
+    std::vector<glm::vec3> exactAccelerations(2000), accelerations(2000);
+    std::vector<float> exactPotentials(2000), potentials(2000);
+    directSum(particles, exactAccelerations, exactPotentials);
+
+    SECTION("Monopole") {
+        fmm::Solver<1> solver{0.4f, 16};
+        solver.solve(particles.positions, particles.masses, accelerations, potentials);
+        auto [median, max] = accelerationErrors(accelerations, exactAccelerations);
+        CAPTURE(median, max);
+        REQUIRE(median < 1e-2f);
+    }
+
+    SECTION("Quadrupole") {
+        fmm::Solver<2> solver{0.4f, 16};
+        solver.solve(particles.positions, particles.masses, accelerations, potentials);
+        auto [median, max] = accelerationErrors(accelerations, exactAccelerations);
+        CAPTURE(median, max);
+        REQUIRE(median < 2e-3f);
+        REQUIRE(max < 1e-1f);
+
+        // A smaller opening angle is more accurate
+        fmm::Solver<2> preciseSolver{0.25f, 16};
+        std::vector<glm::vec3> preciseAccelerations(2000);
+        preciseSolver.solve(particles.positions, particles.masses, preciseAccelerations, potentials);
+        REQUIRE(accelerationErrors(preciseAccelerations, exactAccelerations).first < median);
+
+        for (std::size_t i = 0; i < potentials.size(); ++i)
+            REQUIRE(std::abs(potentials[i] - exactPotentials[i]) < 1e-2f * std::abs(exactPotentials[i]));
+    }
+
+    SECTION("Opening angles above 1") {
+        // Above 1, the acceptance criterion no longer rules out a source which contains the target,
+        // whose moment includes the target's own particles; such sources must still be opened
+        fmm::Solver<2> solver{4.0f, 16};
+        solver.solve(particles.positions, particles.masses, accelerations, potentials);
+        auto [median, max] = accelerationErrors(accelerations, exactAccelerations);
+        CAPTURE(median, max);
+        REQUIRE(median < 0.5f);
+
+        std::vector<float> potentialErrors;
+        for (std::size_t i = 0; i < potentials.size(); ++i)
+            potentialErrors.push_back(std::abs(potentials[i] - exactPotentials[i]) / std::abs(exactPotentials[i]));
+        std::sort(potentialErrors.begin(), potentialErrors.end());
+        REQUIRE(potentialErrors[potentialErrors.size() / 2] < 5e-2f);
+    }
+}
+
+TEST_CASE("Barnes-Hut accuracy", "[FMM]") {
+
+    auto particles = clusteredParticles(2000);
+    std::vector<glm::vec3> exactAccelerations(2000), accelerations(2000);
+    std::vector<float> exactPotentials(2000), potentials(2000);
+    directSum(particles, exactAccelerations, exactPotentials);
+
+    SECTION("Fully opened tree is exact") {
+        fmm::BarnesHut<2> solver{0.0f, 16};
+        solver.solve(particles.positions, particles.masses, accelerations, potentials);
+        REQUIRE(accelerationErrors(accelerations, exactAccelerations).second < 1e-4f);
+    }
+
+    SECTION("Accuracy improves with order") {
+        fmm::BarnesHut<1> monopole{0.5f, 16};
+        monopole.solve(particles.positions, particles.masses, accelerations, potentials);
+        auto [monopoleMedian, monopoleMax] = accelerationErrors(accelerations, exactAccelerations);
+        CAPTURE(monopoleMedian, monopoleMax);
+        REQUIRE(monopoleMedian < 1e-2f);
+
+        fmm::BarnesHut<3> octupole{0.5f, 16};
+        octupole.solve(particles.positions, particles.masses, accelerations, potentials);
+        auto [octupoleMedian, octupoleMax] = accelerationErrors(accelerations, exactAccelerations);
+        CAPTURE(octupoleMedian, octupoleMax);
+        REQUIRE(octupoleMedian < monopoleMedian / 4);
+        REQUIRE(octupoleMax < 5e-2f);
+
+        for (std::size_t i = 0; i < potentials.size(); ++i)
+            REQUIRE(std::abs(potentials[i] - exactPotentials[i]) < 1e-2f * std::abs(exactPotentials[i]));
+    }
+}
+
+TEST_CASE("Work-stealing scheduler", "[FMM]") {
+
+    fmm::Scheduler scheduler{4};
+    REQUIRE(scheduler.threads() == 4);
+
+    SECTION("Parallel loop") {
+        std::vector<std::atomic<int>> visits(10'000);
+        scheduler.parallelFor(0, visits.size(), 7, [&](std::size_t i) { ++visits[i]; });
+        for (const auto &count: visits)
+            REQUIRE(count == 1);
+    }
+
+    SECTION("Chunked loop") {
+        std::vector<std::atomic<int>> visits(10'000);
+        std::vector<std::size_t> sizes(scheduler.threads());
+        const std::size_t chunks = scheduler.parallelChunks(visits.size(), 1000, [&](auto begin, auto end, auto c) {
+            for (std::size_t i = begin; i < end; ++i) ++visits[i];
+            sizes[c] = end - begin;
+        });
+        REQUIRE(chunks == 4);
+        REQUIRE(std::accumulate(sizes.begin(), sizes.end(), std::size_t{0}) == visits.size());
+        for (const auto &count: visits)
+            REQUIRE(count == 1);
+    }
+
+    SECTION("Nested tasks") {
+        // Tasks which spawn and wait on their own groups, as in the upward pass
+        std::function<std::size_t(std::size_t)> count = [&](std::size_t depth) -> std::size_t {
+            if (depth == 0) return 1;
+            fmm::TaskGroup group;
+            std::array<std::size_t, 4> results{};
+            for (std::size_t c = 0; c < results.size(); ++c)
+                scheduler.spawn(group, [&, c] { results[c] = count(depth - 1); });
+            scheduler.wait(group);
+            return std::accumulate(results.begin(), results.end(), std::size_t{0});
+        };
+        REQUIRE(count(6) == 4096);
+    }
+
+    SECTION("Results don't depend on the number of threads") {
+        auto particles = clusteredParticles(20'000);
+        fmm::Scheduler serial{1};
+
+        // The tree itself, including the order of its nodes
+        fmm::Octree serialTree{particles.positions, 16, serial}, tree{particles.positions, 16, scheduler};
+        REQUIRE(tree.order() == serialTree.order());
+        REQUIRE(tree.nodes().size() == serialTree.nodes().size());
+        for (std::size_t n = 0; n < tree.nodes().size(); ++n) {
+            const auto &node = tree.nodes()[n], &serialNode = serialTree.nodes()[n];
+            REQUIRE(node.center == serialNode.center);
+            REQUIRE(std::tie(node.begin, node.end, node.firstChild, node.numChildren) ==
+                    std::tie(serialNode.begin, serialNode.end, serialNode.firstChild, serialNode.numChildren));
+        }
+
+        std::vector<glm::vec3> accelerations(20'000), serialAccelerations(20'000);
+        std::vector<float> potentials(20'000), serialPotentials(20'000);
+
+        fmm::Solver<2>{0.5f, 16, serial}.solve(particles.positions, particles.masses,
+                                               serialAccelerations, serialPotentials);
+        fmm::Solver<2>{0.5f, 16, scheduler}.solve(particles.positions, particles.masses,
+                                                  accelerations, potentials);
+        REQUIRE(accelerations == serialAccelerations);
+        REQUIRE(potentials == serialPotentials);
+
+        fmm::BarnesHut<2>{0.5f, 16, serial}.solve(particles.positions, particles.masses,
+                                                  serialAccelerations, serialPotentials);
+        fmm::BarnesHut<2>{0.5f, 16, scheduler}.solve(particles.positions, particles.masses,
+                                                     accelerations, potentials);
+        REQUIRE(accelerations == serialAccelerations);
+        REQUIRE(potentials == serialPotentials);
+    }
+}
@@ -0,0 +1,389 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+
+#include <cmath>
+
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+
+#include <symtensor/gravity/kernels.h>
+#include <symtensor/glm.h>
+
+using namespace symtensor;
+namespace radial = symtensor::gravity::radial;
+using enum SymmetricTensor3f<1>::Index;
+
+// Largest relative difference between the elements of two tensors, compared to the largest element of the first
+template<typename A, typename B>
+static double relativeDifference(const A &a, const B &b) {
+    double scale = 0, difference = 0;
+    for (std::size_t i = 0; i < A::NumUniqueValues; ++i) {
+        const auto index = A::dimensionalIndices(i);
+        scale = std::max(scale, std::abs(static_cast<double>(a[index])));
+        difference = std::max(difference, std::abs(static_cast<double>(a[index]) - static_cast<double>(b[index])));
+    }
+    return difference / scale;
+}
+
+TEST_CASE("Einsum gravity derivatives match the other backends", "[Gravity]") {
+
+    const glm::vec3 R{0.3f, -1.2f, 0.7f};
+
+    [&]<std::size_t... N>(std::index_sequence<N...>) {
+        ([&]<std::size_t Order>(std::integral_constant<std::size_t, Order>) {
+            CAPTURE(Order);
+            CHECK(relativeDifference(gravity::direct::derivative<Order>(R),
+                                     gravity::einsum::derivative<Order>(R)) < 1e-5);
+            CHECK(relativeDifference(gravity::tensorlib::derivative<Order>(R),
+                                     gravity::einsum::derivative<Order>(R)) < 1e-5);
+        }(std::integral_constant<std::size_t, N + 1>{}), ...);
+    }(std::make_index_sequence<5>());
+
+    // Single elements agree with the full tensor
+    const auto D5 = gravity::einsum::derivative<5>(R);
+    CHECK(gravity::einsum::derivative_at<std::array{X, X, Y, Z, Z}, 5>(R) == D5[std::array{X, X, Y, Z, Z}]);
+    CHECK(gravity::einsum::derivative_at<std::array{Z, Z, Z, Z, Z}, 5>(R) == D5[std::array{Z, Z, Z, Z, Z}]);
+}
+
+TEST_CASE("Einsum gravity derivatives of arbitrary order", "[Gravity]") {
+
+    const glm::dvec3 R{0.3, -1.2, 0.7};
+
+    [&]<std::size_t... N>(std::index_sequence<N...>) {
+        ([&]<std::size_t Order>(std::integral_constant<std::size_t, Order>) {
+            CAPTURE(Order);
+            const auto D = gravity::einsum::derivative<Order>(R);
+            using Tensor = std::remove_cvref_t<decltype(D)>;
+
+            // Each derivative is the gradient of the one before it, which is checked by central differences
+            constexpr double h = 1e-4;
+            const auto forward = [&](std::size_t d) {
+                glm::dvec3 offset{0};
+                offset[static_cast<int>(d)] = h;
+                return std::make_pair(gravity::einsum::derivative<Order - 1>(R + offset),
+                                      gravity::einsum::derivative<Order - 1>(R - offset));
+            };
+            const std::array differences{forward(0), forward(1), forward(2)};
+            double scale = 0, error = 0;
+            for (std::size_t i = 0; i < Tensor::NumUniqueValues; ++i) {
+                const auto index = Tensor::dimensionalIndices(i);
+                std::array<typename Tensor::Index, Order - 1> head{};
+                std::copy(index.begin(), index.end() - 1, head.begin());
+                const auto &[plus, minus] = differences[static_cast<std::size_t>(index.back())];
+                const double expected = (plus[head] - minus[head]) / (2 * h);
+                scale = std::max(scale, std::abs(D[index]));
+                error = std::max(error, std::abs(D[index] - expected));
+            }
+            CHECK(error / scale < 1e-6);
+
+            // 1 / r is harmonic, so every derivative is traceless
+            double trace = 0;
+            using Trace = SymmetricTensor<double, 3, Order - 2>;
+            for (std::size_t i = 0; i < Trace::NumUniqueValues; ++i) {
+                const auto index = Trace::dimensionalIndices(i);
+                double sum = 0;
+                for (auto d: {X, Y, Z}) {
+                    std::array<typename Tensor::Index, Order> full{};
+                    std::copy(index.begin(), index.end(), full.begin());
+                    full[Order - 2] = full[Order - 1] = d;
+                    sum += D[full];
+                }
+                trace = std::max(trace, std::abs(sum));
+            }
+            CHECK(trace / scale < 1e-12);
+
+        }(std::integral_constant<std::size_t, N + 3>{}), ...);
+    }(std::make_index_sequence<8>());
+
+    // The gravity kernels accept the higher orders
+    STATIC_REQUIRE(gravity::Einsum::MaxOrder >= 10);
+}
+
+TEST_CASE("All einsum gravity derivatives in one pass", "[Gravity]") {
+
+    const glm::vec3 R{0.3f, -1.2f, 0.7f};
+    const auto D = gravity::einsum::derivatives<6>(R);
+    STATIC_REQUIRE(std::is_same_v<std::remove_cvref_t<decltype(gravity::einsum::derivatives<4>(R))>, Multipole3f<4>>);
+
+    // Sharing the radial factors between ranks shouldn't change any of the tensors
+    [&]<std::size_t... N>(std::index_sequence<N...>) {
+        ([&]<std::size_t Order>(std::integral_constant<std::size_t, Order>) {
+            CAPTURE(Order);
+            CHECK(relativeDifference(D.template tensor<Order>(), gravity::einsum::derivative<Order>(R)) < 1e-6);
+        }(std::integral_constant<std::size_t, N + 1>{}), ...);
+    }(std::make_index_sequence<6>());
+}
+
+TEST_CASE("Generated gravity derivative kernels", "[Gravity]") {
+
+    const glm::vec3 R{0.3f, -1.2f, 0.7f};
+    const glm::dvec3 R_double{0.3, -1.2, 0.7};
+    const glm::dvec2 R_2d{0.3, -1.2};
+    const auto all = gravity::tensorlib::derivatives<10>(R_double);
+
+    [&]<std::size_t... N>(std::index_sequence<N...>) {
+        ([&]<std::size_t Order>(std::integral_constant<std::size_t, Order>) {
+            CAPTURE(Order);
+
+            // The kernels agree with the einsum backend, in both float and double precision.
+            // Rounding differs between the two, and cancellation grows with the order
+            CHECK(relativeDifference(gravity::einsum::derivative<Order>(R),
+                                     gravity::tensorlib::derivative<Order>(R)) < 1e-4);
+            CHECK(relativeDifference(gravity::einsum::derivative<Order>(R_double),
+                                     gravity::tensorlib::derivative<Order>(R_double)) < 1e-12);
+
+            // Single-rank kernels match the corresponding rank of the combined kernel
+            CHECK(relativeDifference(all.template tensor<Order>(),
+                                     gravity::tensorlib::derivative<Order>(R_double)) < 1e-12);
+
+            // In 2D, elements match the in-plane elements of the 3D derivative at z = 0
+            const auto D2 = gravity::tensorlib::derivative<Order>(R_2d);
+            const auto D3 = gravity::tensorlib::derivative<Order>(glm::dvec3{R_2d.x, R_2d.y, 0.0});
+            using Tensor2D = std::remove_cvref_t<decltype(D2)>;
+            using Index3D = typename std::remove_cvref_t<decltype(D3)>::Index;
+            double error = 0;
+            for (std::size_t i = 0; i < Tensor2D::NumUniqueValues; ++i) {
+                std::array<Index3D, Order> index{};
+                for (std::size_t r = 0; r < Order; ++r)
+                    index[r] = Index3D(static_cast<std::size_t>(Tensor2D::dimensionalIndices(i)[r]));
+                error = std::max(error, std::abs(D2[i] - D3[index]) / std::max(std::abs(D3[index]), 1.0));
+            }
+            CHECK(error < 1e-12);
+
+        }(std::integral_constant<std::size_t, N + 1>{}), ...);
+    }(std::make_index_sequence<10>());
+
+    STATIC_REQUIRE(gravity::Tensorlib::MaxOrder >= 10);
+}
+
+TEST_CASE("Gravity derivatives in double and mixed precision", "[Gravity]") {
+
+    const glm::dvec3 R{0.3, -1.2, 0.7};
+
+    // Every backend computes in the scalar type of the separation
+    [&]<std::size_t... N>(std::index_sequence<N...>) {
+        ([&]<std::size_t Order>(std::integral_constant<std::size_t, Order>) {
+            CAPTURE(Order);
+            STATIC_REQUIRE(std::is_same_v<typename decltype(gravity::direct::derivative<Order>(R))::Scalar, double>);
+            CHECK(relativeDifference(gravity::direct::derivative<Order>(R),
+                                     gravity::einsum::derivative<Order>(R)) < 1e-12);
+            CHECK(relativeDifference(gravity::direct::derivative<Order>(R),
+                                     gravity::tensorlib::derivative<Order>(R)) < 1e-12);
+        }(std::integral_constant<std::size_t, N + 1>{}), ...);
+    }(std::make_index_sequence<5>());
+
+    // Mixed precision stores the double precision result, rounded to float
+    const glm::vec3 R_float{R};
+    const auto mixed = gravity::MixedPrecision<gravity::Einsum>::derivatives<5>(R_float);
+    const auto wide = gravity::einsum::derivatives<5>(glm::dvec3{R_float});
+    STATIC_REQUIRE(std::is_same_v<std::remove_cvref_t<decltype(std::get<4>(mixed))>, SymmetricTensor3f<5>>);
+    for (std::size_t i = 0; i < SymmetricTensor3f<5>::NumUniqueValues; ++i)
+        CHECK(std::get<4>(mixed)[i] == static_cast<float>(wide.tensor<5>()[i]));
+
+    // The separation may be any vector, including a symmetric tensor or one with vector scalars,
+    // which is computed in a simd of doubles with the same number of lanes
+    const SymmetricTensor3f<1> R_tensor{R_float.x, R_float.y, R_float.z};
+    const auto mixedTensor = gravity::MixedPrecision<gravity::Einsum>::derivatives<5>(R_tensor);
+    CHECK(std::get<4>(mixedTensor) == std::get<4>(mixed));
+
+    using SimdScalar = std::experimental::native_simd<float>;
+    const SymmetricTensor<SimdScalar, 3, 1> R_simd{
+            SimdScalar{[&](auto lane) { return R_float.x * static_cast<float>(lane + 1); }},
+            SimdScalar{[&](auto lane) { return R_float.y * static_cast<float>(lane + 1); }},
+            SimdScalar{[&](auto lane) { return R_float.z * static_cast<float>(lane + 1); }}
+    };
+    const auto mixedSimd = std::get<2>(gravity::MixedPrecision<gravity::Tensorlib>::derivatives<3>(R_simd));
+    STATIC_REQUIRE(std::is_same_v<std::remove_cvref_t<decltype(mixedSimd)>, SymmetricTensor<SimdScalar, 3, 3>>);
+    for (std::size_t lane = 0; lane < SimdScalar::size(); ++lane) {
+        CAPTURE(lane);
+        const auto expectedLane = gravity::einsum::derivative<3>(glm::dvec3{R_float} * static_cast<double>(lane + 1));
+        for (std::size_t i = 0; i < SymmetricTensor3f<3>::NumUniqueValues; ++i)
+            CHECK_THAT(mixedSimd[i][lane], Catch::Matchers::WithinRel(static_cast<float>(expectedLane[i]), 1e-6f));
+    }
+
+    // At small separations the radial factors overflow single precision, even where the derivatives are representable
+    const glm::vec3 close{3e-3f, 4e-3f, 0.0f};
+    const auto expected = gravity::einsum::derivative<8>(glm::dvec3{close});
+    const auto closeMixed = std::get<7>(gravity::MixedPrecision<gravity::Einsum>::derivatives<8>(close));
+    const auto closeFloat = gravity::einsum::derivative<8>(close);
+    bool allFinite = true;
+    for (std::size_t i = 0; i < SymmetricTensor3f<8>::NumUniqueValues; ++i)
+        allFinite &= std::isfinite(closeFloat[i]);
+    CHECK_FALSE(allFinite);
+    CHECK(relativeDifference(expected, closeMixed) < 1e-6);
+
+    // The policy can be used anywhere a backend can
+    LocalExpansion3f<2> local{}, localMixed{};
+    const auto moment = QuadrupoleMoment3f::FromPosition(glm::vec3{0.1f, 0.2f, -0.1f});
+    gravity::multipoleToLocal<gravity::Einsum>(local, moment, R_float);
+    gravity::multipoleToLocal<gravity::MixedPrecision<gravity::Tensorlib>>(localMixed, moment, R_float);
+    CHECK(relativeDifference(local.tensor<2>(), localMixed.tensor<2>()) < 1e-5);
+}
+
+// Largest relative error of the N-th derivative of a potential, against central differences of the (N - 1)-th,
+// where derivativesOf(R) gives the derivatives of ranks 1 through N, and potentialOf(R) the potential itself
+template<std::size_t Order, typename Potential, typename Derivatives>
+static double finiteDifferenceError(const Potential &potentialOf, const Derivatives &derivativesOf,
+                                    const glm::dvec3 &R) {
+    constexpr double h = 1e-5;
+    const auto D = derivativesOf(R).template tensor<Order>();
+    using Tensor = std::remove_cvref_t<decltype(D)>;
+    using Head = std::array<typename Tensor::Index, Order - 1>;
+    const auto lower = [&](const glm::dvec3 &position, const Head &head) {
+        if constexpr (Order == 1)
+            return potentialOf(position);
+        else
+            return derivativesOf(position).template tensor<Order - 1>()[head];
+    };
+
+    double scale = 0, error = 0;
+    for (std::size_t i = 0; i < Tensor::NumUniqueValues; ++i) {
+        const auto index = Tensor::dimensionalIndices(i);
+        Head head{};
+        std::copy(index.begin(), index.end() - 1, head.begin());
+        glm::dvec3 offset{0};
+        offset[static_cast<int>(index.back())] = h;
+        const double expected = (lower(R + offset, head) - lower(R - offset, head)) / (2 * h);
+        scale = std::max(scale, std::abs(D[index]));
+        error = std::max(error, std::abs(D[index] - expected));
+    }
+    return error / scale;
+}
+
+TEST_CASE("Softened gravity derivatives", "[Gravity]") {
+
+    constexpr double epsilon = 0.3, h = 1.0;
+    const auto plummerPotential = [&](const glm::dvec3 &R) {
+        return gravity::plummer::radial_factors<0>(R, epsilon)[0];
+    };
+    const auto plummerDerivatives = [&](const glm::dvec3 &R) {
+        return gravity::plummer::derivatives<5>(R, epsilon);
+    };
+    const auto splinePotential = [&](const glm::dvec3 &R) {
+        return gravity::spline::radial_factors<0>(R, h)[0];
+    };
+    const auto splineDerivatives = [&](const glm::dvec3 &R) {
+        return gravity::spline::derivatives<5>(R, h);
+    };
+
+    // Separations within each branch of the spline: r < h / 2, h / 2 < r < h, and r > h
+    const std::array separations{
+            glm::dvec3{0.1, -0.2, 0.15},
+            glm::dvec3{0.4, -0.5, 0.3},
+            glm::dvec3{1.2, -0.9, 0.6}
+    };
+    for (const auto &R: separations) {
+        CAPTURE(R.x, R.y, R.z);
+        [&]<std::size_t... N>(std::index_sequence<N...>) {
+            ([&]<std::size_t Order>(std::integral_constant<std::size_t, Order>) {
+                CAPTURE(Order);
+                CHECK(finiteDifferenceError<Order>(plummerPotential, plummerDerivatives, R) < 1e-6);
+                CHECK(finiteDifferenceError<Order>(splinePotential, splineDerivatives, R) < 1e-6);
+            }(std::integral_constant<std::size_t, N + 1>{}), ...);
+        }(std::make_index_sequence<5>());
+    }
+
+    // Beyond its softening length the spline is exactly Newtonian
+    const auto far = gravity::spline::derivatives<5>(separations[2], h);
+    const auto newtonian = gravity::einsum::derivatives<5>(separations[2]);
+    CHECK(relativeDifference(newtonian.tensor<5>(), far.tensor<5>()) < 1e-15);
+
+    // The potential and its gradient are continuous where the spline changes branch
+    for (double boundary: {h / 2, h}) {
+        CAPTURE(boundary);
+        const glm::dvec3 direction{0.6, 0.0, 0.8};
+        const auto below = gravity::spline::radial_factors<1>(direction * (boundary * (1 - 1e-9)), h);
+        const auto above = gravity::spline::radial_factors<1>(direction * (boundary * (1 + 1e-9)), h);
+        CHECK_THAT(below[0], Catch::Matchers::WithinRel(above[0], 1e-7));
+        CHECK_THAT(below[1], Catch::Matchers::WithinRel(above[1], 1e-7));
+    }
+
+    // Both softenings are finite at zero separation, where the spline matches Plummer with epsilon = h / 2.8
+    const glm::dvec3 zero{0.0};
+    CHECK_THAT(gravity::spline::radial_factors<0>(zero, h)[0], Catch::Matchers::WithinRel(2.8 / h, 1e-12));
+    CHECK_THAT(gravity::plummer::radial_factors<0>(zero, h / 2.8)[0], Catch::Matchers::WithinRel(2.8 / h, 1e-12));
+    const auto center = gravity::spline::derivatives<2>(zero, h).tensor<2>();
+    CHECK(std::isfinite(center[std::array{X, X}]));
+    CHECK(center[std::array{X, X}] == center[std::array{Z, Z}]);
+}
+
+TEST_CASE("Softened gravity derivatives with SIMD scalars", "[Gravity]") {
+
+    using SimdScalar = std::experimental::native_simd<float>;
+    using SimdVector = SymmetricTensor<SimdScalar, 3, 1>;
+    static constexpr std::size_t simd_size = SimdScalar::size();
+
+    // Lanes fall on different branches of the spline
+    std::array<glm::vec3, simd_size> R{};
+    for (std::size_t lane = 0; lane < simd_size; ++lane)
+        R[lane] = glm::vec3{0.1f, 0.2f, 0.3f} * static_cast<float>(lane + 1);
+    auto R_simd = SimdVector::NullaryExpression([&](auto index) {
+        return SimdScalar{[&](auto lane) { return R[lane][static_cast<int>(index[0])]; }};
+    });
+
+    const auto spline = gravity::spline::derivatives<3>(R_simd, SimdScalar{1.0f});
+    const auto plummer = gravity::plummer::derivatives<3>(R_simd, SimdScalar{0.3f});
+    for (std::size_t lane = 0; lane < simd_size; ++lane) {
+        CAPTURE(lane);
+        const auto lane_of = [&](const auto &tensor) {
+            return SymmetricTensor3f<3>::NullaryExpression([&]<auto index>() {
+                return tensor.template at<index>()[lane];
+            });
+        };
+        CHECK(relativeDifference(gravity::spline::derivatives<3>(R[lane], 1.0f).tensor<3>(),
+                                 lane_of(spline.tensor<3>())) < 1e-5);
+        CHECK(relativeDifference(gravity::plummer::derivatives<3>(R[lane], 0.3f).tensor<3>(),
+                                 lane_of(plummer.tensor<3>())) < 1e-5);
+    }
+}
+
+TEST_CASE("Derivatives of other radial potentials", "[Gravity]") {
+
+    const glm::dvec3 R{0.3, -1.2, 0.7};
+    const std::tuple potentials{
+            radial::Yukawa{0.7},
+            radial::ShortRange{1.3},
+            radial::LongRange{1.3},
+            radial::Plummer{0.3},
+            radial::Spline{2.0}
+    };
+
+    std::apply([&](const auto &...potential) {
+        ([&]() {
+            const auto potentialOf = [&](const glm::dvec3 &position) {
+                return gravity::einsum::radial_factors<0>(position, potential)[0];
+            };
+            const auto derivativesOf = [&](const glm::dvec3 &position) {
+                return gravity::einsum::derivatives<5>(position, potential);
+            };
+            const auto generated = gravity::tensorlib::derivatives<5>(R, potential);
+            [&]<std::size_t... N>(std::index_sequence<N...>) {
+                ([&]<std::size_t Order>(std::integral_constant<std::size_t, Order>) {
+                    CAPTURE(Order);
+
+                    // Each potential's derivatives agree with its finite differences
+                    CHECK(finiteDifferenceError<Order>(potentialOf, derivativesOf, R) < 1e-6);
+
+                    // The generated kernels take the same radial factors as einsum
+                    CHECK(relativeDifference(derivativesOf(R).template tensor<Order>(),
+                                             generated.template tensor<Order>()) < 1e-12);
+                }(std::integral_constant<std::size_t, N + 1>{}), ...);
+            }(std::make_index_sequence<5>());
+        }(), ...);
+    }, potentials);
+
+    // The two parts of an Ewald split add up to 1 / r
+    const auto newtonian = gravity::einsum::derivatives<5>(R);
+    const auto shortRange = gravity::einsum::derivatives<5>(R, radial::ShortRange{1.3});
+    const auto longRange = gravity::einsum::derivatives<5>(R, radial::LongRange{1.3});
+    const SymmetricTensor<double, 3, 5> sum = shortRange.tensor<5>() + longRange.tensor<5>();
+    CHECK(relativeDifference(newtonian.tensor<5>(), sum) < 1e-12);
+
+    // The Yukawa potential reduces to 1 / r without screening, and otherwise satisfies (laplacian - kappa^2) phi = 0
+    CHECK(relativeDifference(newtonian.tensor<5>(),
+                             gravity::einsum::derivatives<5>(R, radial::Yukawa{0.0}).tensor<5>()) < 1e-15);
+    const auto yukawa = gravity::einsum::derivative<2>(R, radial::Yukawa{0.7});
+    const double laplacian = yukawa[std::array{X, X}] + yukawa[std::array{Y, Y}] + yukawa[std::array{Z, Z}];
+    CHECK_THAT(laplacian, Catch::Matchers::WithinRel(0.7 * 0.7 * radial::Yukawa{0.7}.factors<0>(glm::length2(R))[0],
+                                                     1e-12));
+}
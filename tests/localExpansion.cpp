@@ -0,0 +1,157 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+
+#include <random>
+
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+#include <glm/geometric.hpp>
+
+#include <symtensor/LocalExpansion.h>
+#include <symtensor/gravity/kernels.h>
+#include <symtensor/glm.h>
+
+using namespace symtensor;
+
+static std::vector<glm::vec4> randomParticles(std::size_t count) {
+    std::mt19937 generator{0u};
+    std::uniform_real_distribution<float> positionDistribution{-0.5f, 0.5f};
+    std::uniform_real_distribution<float> massDistribution{0.1f, 1.0f};
+    std::vector<glm::vec4> particles{};
+    for (std::size_t i = 0; i < count; ++i)
+        particles.emplace_back(
+                positionDistribution(generator),
+                positionDistribution(generator),
+                positionDistribution(generator),
+                massDistribution(generator)
+        );
+    return particles;
+}
+
+template<typename Moment>
+static Moment momentOf(const std::vector<glm::vec4> &particles) {
+    Moment moment{};
+    for (const auto &particle: particles)
+        moment += Moment::FromPosition(glm::vec3{particle}) * particle.w;
+    return moment;
+}
+
+TEST_CASE("Local expansion constructors", "[LocalExpansion]") {
+
+    REQUIRE(LocalExpansion3f<2>{} == LocalExpansion3f<2>{0, {0, 0, 0}, {0, 0, 0, 0, 0, 0}});
+
+    LocalExpansion3f<1> local{1, {2, 3, 4}};
+    REQUIRE(local.scalar() == 1);
+    REQUIRE(local.tensor<1>() == SymmetricTensor3f<1>{2, 3, 4});
+}
+
+TEST_CASE("Multipole to local translation", "[LocalExpansion]") {
+
+    auto particles = randomParticles(64);
+    auto target = glm::vec3{6, -4, 5};
+
+    // Exact values at the target center
+    float potential = 0;
+    glm::vec3 acceleration{};
+    SymmetricTensor3f<2> tidalTensor{};
+    for (const auto &particle: particles) {
+        auto R = target - glm::vec3{particle};
+        potential += particle.w / glm::length(R);
+        acceleration += -R * (particle.w / std::pow(glm::length(R), 3.0f));
+        tidalTensor += gravity::direct::derivative<2>(R) * particle.w;
+    }
+
+    auto moment = momentOf<OctupoleMoment3f>(particles);
+    LocalExpansion3f<2> local{};
+    gravity::multipoleToLocal(local, moment, target);
+
+    CHECK_THAT(local.scalar(), Catch::Matchers::WithinRel(potential, 1e-4f));
+    CHECK_THAT(glm::length(to_glm(local.tensor<1>()) - acceleration),
+               Catch::Matchers::WithinAbs(0, 1e-4 * glm::length(acceleration)));
+    CHECK_THAT((local.tensor<2>() - tidalTensor).norm(),
+               Catch::Matchers::WithinAbs(0, 1e-3 * tidalTensor.norm()));
+
+    // Interactions accumulate
+    auto twice = local;
+    gravity::multipoleToLocal(twice, moment, target);
+    CHECK((twice.tensor<2>() - local.tensor<2>() * 2.0f).norm() < 1e-6 * local.tensor<2>().norm());
+
+    // Every derivative backend produces the same expansion
+    auto quadrupole = momentOf<QuadrupoleMoment3f>(particles);
+    LocalExpansion3f<2> direct{}, einsum{}, tensorlib{};
+    gravity::multipoleToLocal<gravity::Direct>(direct, quadrupole, target);
+    gravity::multipoleToLocal<gravity::Einsum>(einsum, quadrupole, target);
+    gravity::multipoleToLocal<gravity::Tensorlib>(tensorlib, quadrupole, target);
+    CHECK((direct.tensor<2>() - einsum.tensor<2>()).norm() < 1e-5 * direct.tensor<2>().norm());
+    CHECK((direct.tensor<2>() - tensorlib.tensor<2>()).norm() < 1e-5 * direct.tensor<2>().norm());
+}
+
+TEST_CASE("Local expansion evaluation", "[LocalExpansion]") {
+
+    // The value of a quadratic field and its gradient
+    LocalExpansion3f<2> local{1, {2, 3, 4}, {2, 0, 0, 4, 0, 6}};
+    std::vector<glm::vec3> positions{{1, 1, 1}, {1, 0, 0}, {0, 1, 2}};
+    std::vector<glm::vec3> gradients(positions.size());
+    std::vector<float> values(positions.size());
+    local.evaluate(glm::vec3{0, 1, 0}, std::span<const glm::vec3>{positions}, std::span{gradients}, std::span{values});
+    // f(x) = 1 + 2x + 3y + 4z + x^2 + 2y^2 + 3z^2, at offsets (1, 0, 1), (1, -1, 0) and (0, 0, 2)
+    CHECK(values == std::vector<float>{11, 3, 21});
+    CHECK(gradients == std::vector<glm::vec3>{{4, 3, 10}, {4, -1, 4}, {2, 3, 16}});
+
+    // Evaluation accumulates, and handles more particles than fit in a single block
+    auto particles = randomParticles(100);
+    auto moment = momentOf<OctupoleMoment3f>(particles);
+    auto center = glm::vec3{6, -4, 5};
+    LocalExpansion3f<2> farField{};
+    gravity::multipoleToLocal(farField, moment, center);
+
+    std::vector<glm::vec3> targets{};
+    for (const auto &particle: randomParticles(37))
+        targets.push_back(center + glm::vec3{particle} * 0.2f);
+    std::vector<glm::vec3> accelerations(targets.size(), glm::vec3{1, 1, 1});
+    std::vector<float> potentials(targets.size(), 1.0f);
+    farField.evaluate(center, std::span<const glm::vec3>{targets}, std::span{accelerations}, std::span{potentials});
+    for (std::size_t i = 0; i < targets.size(); ++i) {
+        float potential = 0;
+        glm::vec3 acceleration{};
+        for (const auto &particle: particles) {
+            auto R = targets[i] - glm::vec3{particle};
+            potential += particle.w / glm::length(R);
+            acceleration += -R * (particle.w / std::pow(glm::length(R), 3.0f));
+        }
+        CHECK_THAT(potentials[i] - 1.0f, Catch::Matchers::WithinRel(potential, 1e-4f));
+        CHECK_THAT(glm::length(accelerations[i] - glm::vec3{1, 1, 1} - acceleration),
+                   Catch::Matchers::WithinAbs(0, 1e-3 * glm::length(acceleration)));
+    }
+}
+
+TEST_CASE("Local to local translation", "[LocalExpansion]") {
+
+    LocalExpansion3f<3> local{
+            1, {2, 3, 4}, {2, 0, 1, 4, 0, 6},
+            SymmetricTensor3f<3>{1, 2, 0, 1, 0, 3, 1, 0, 2, 1}
+    };
+    auto offset = glm::vec3{1, -1, 2};
+    auto translated = local.translated(offset);
+
+    // The expansion is a polynomial, so the translated expansion gives exactly the same field
+    std::vector<glm::vec3> positions{{0, 0, 0}, {1, 2, 3}, {-2, 1, 0}};
+    std::vector<glm::vec3> gradients(positions.size()), translatedGradients(positions.size());
+    std::vector<float> values(positions.size()), translatedValues(positions.size());
+    local.evaluate(glm::vec3{}, std::span<const glm::vec3>{positions}, std::span{gradients}, std::span{values});
+    translated.evaluate(offset, std::span<const glm::vec3>{positions},
+                        std::span{translatedGradients}, std::span{translatedValues});
+    for (std::size_t i = 0; i < positions.size(); ++i) {
+        CHECK_THAT(translatedValues[i], Catch::Matchers::WithinRel(values[i], 1e-6f));
+        CHECK_THAT(glm::length(translatedGradients[i] - gradients[i]),
+                   Catch::Matchers::WithinAbs(0, 1e-6 * glm::length(gradients[i])));
+    }
+
+    // The first tensor of the translated expansion is the gradient at the new center
+    std::vector<glm::vec3> centerGradient(1);
+    std::vector<float> centerValue(1);
+    local.evaluate(glm::vec3{}, std::span<const glm::vec3>{&offset, 1}, std::span{centerGradient}, std::span{centerValue});
+    CHECK_THAT(translated.scalar(), Catch::Matchers::WithinRel(centerValue[0], 1e-6f));
+    CHECK_THAT(glm::length(to_glm(translated.tensor<1>()) - centerGradient[0]),
+               Catch::Matchers::WithinAbs(0, 1e-6 * glm::length(centerGradient[0])));
+}
@@ -70,6 +70,19 @@ TEST_CASE("Arithmetic operations with another multipole", "[Multipole]") {
                                   {3, 4, 5}});
     REQUIRE(a - b == Quadrupole2f{{-1, 0},
                                   {-1, 0, 1}});
+
+    // Chains of operations are evaluated lazily, tensor by tensor
+    auto expression = a + b * 2.0f - a;
+    STATIC_REQUIRE(multipole_expression<decltype(expression)>);
+    Quadrupole2f result = expression;
+    REQUIRE(result == Quadrupole2f{{4, 4},
+                                   {4, 4, 4}});
+    REQUIRE(expression / 2 == Quadrupole2f{{2, 2},
+                                           {2, 2, 2}});
+
+    result += a - b;
+    REQUIRE(result == Quadrupole2f{{3, 4},
+                                   {3, 4, 5}});
 }
 
 
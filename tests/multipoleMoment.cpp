@@ -1,11 +1,13 @@
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/generators/catch_generators.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
 #include <random>
 
 #include <symtensor/MultipoleMoment.h>
 #include <symtensor/glm.h>
 
 #include <iostream>
+#include <experimental/simd>
 
 #define GLM_FORCE_SWIZZLE
 #define GLM_ENABLE_EXPERIMENTAL
@@ -17,7 +19,7 @@ using namespace symtensor;
 
 // todo: this needs to be regularized -- there must be a pattern!
 template<std::size_t Order>
-[[gnu::always_inline]] inline auto D(const glm::vec3 &R, float r) {
+[[gnu::always_inline]] inline SymmetricTensor3f<Order> D(const glm::vec3 &R, float r) {
 
 #if (__cpp_using_enum && !__clang__) || (__clang_major__ > 15)
     using
@@ -42,7 +44,7 @@ template<std::size_t Order>
 
     if constexpr (Order == 1) {
 
-        return g1 * R;
+        return g1 * SymmetricTensor3f<1>{R.x, R.y, R.z};
 
     } else if constexpr (Order == 2) {
 
@@ -104,6 +106,58 @@ TEST_CASE("Multipole moment constructors", "[MultipoleMoment]") {
 
 }
 
+TEST_CASE("Traceless multipole moments", "[MultipoleMoment]") {
+
+    auto position = glm::vec3{1, 2, 3};
+    float r = glm::length(position);
+    auto moment = HexadecupoleMoment3f::TracelessFromPosition(position);
+
+    REQUIRE(moment.tensor<1>() == SymmetricTensor3f<1>{1, 2, 3});
+    CHECK_THAT((moment.tensor<2>() - SymmetricTensor3f<2>{-11, 6, 9, -2, 18, 13}).norm(),
+               Catch::Matchers::WithinAbs(0, 1e-5));
+
+    // Each tensor is proportional to the matching derivative of 1 / r
+    CHECK_THAT((moment.tensor<2>() / pow<5>(r) - D<2>(position, r)).norm(),
+               Catch::Matchers::WithinAbs(0, 1e-5 * D<2>(position, r).norm()));
+    CHECK_THAT((moment.tensor<3>() / -pow<7>(r) - D<3>(position, r)).norm(),
+               Catch::Matchers::WithinAbs(0, 1e-5 * D<3>(position, r).norm()));
+    CHECK_THAT((moment.tensor<4>() / pow<9>(r) - D<4>(position, r)).norm(),
+               Catch::Matchers::WithinAbs(0, 1e-5 * D<4>(position, r).norm()));
+}
+
+TEST_CASE("Multipole moment arithmetic", "[MultipoleMoment]") {
+
+    auto a = QuadrupoleMoment3f::FromPosition(glm::vec3{1, 2, 3});
+    auto b = QuadrupoleMoment3f::FromPosition(glm::vec3{3, 2, 1});
+
+    REQUIRE(a + b == QuadrupoleMoment3f{2, {4, 4, 4}, {10, 8, 6, 8, 8, 10}});
+    REQUIRE(a * 2.0f == QuadrupoleMoment3f{2, {2, 4, 6}, {2, 4, 6, 8, 12, 18}});
+
+    // Division only normalizes the first-order tensor, whether or not it is applied to an expression
+    REQUIRE(a / 2.0f == QuadrupoleMoment3f{1, {0.5, 1, 1.5}, {1, 2, 3, 4, 6, 9}});
+    REQUIRE((a + b) / 2.0f == QuadrupoleMoment3f{2, {2, 2, 2}, {10, 8, 6, 8, 8, 10}});
+}
+
+TEST_CASE("Multipole moments with SIMD scalars", "[MultipoleMoment]") {
+
+    using SimdScalar = std::experimental::native_simd<float>;
+    using SimdQuadrupoleMoment3f = MultipoleMoment<2, SymmetricTensor<SimdScalar, 3, 1>>;
+
+    // Every lane holds the same position, so every lane should match the scalar moment
+    auto position = SymmetricTensor<SimdScalar, 3, 1>{SimdScalar{1}, SimdScalar{2}, SimdScalar{3}};
+    auto quadrupole = SimdQuadrupoleMoment3f::FromPosition(position);
+    REQUIRE(quadrupole == SimdQuadrupoleMoment3f{
+            SimdScalar{1},
+            {SimdScalar{1}, SimdScalar{2}, SimdScalar{3}},
+            {SimdScalar{1}, SimdScalar{2}, SimdScalar{3}, SimdScalar{4}, SimdScalar{6}, SimdScalar{9}}
+    });
+
+    // Changing a single lane of the scalar component breaks equality
+    auto modified = quadrupole;
+    modified.scalar()[0] = 2;
+    REQUIRE(modified != quadrupole);
+}
+
 static glm::vec3 gravitationalAcceleration(std::vector<glm::vec4> particles, glm::vec3 position) {
     return std::transform_reduce(
             particles.begin(), particles.end(),
@@ -138,6 +192,38 @@ static float accelerationError(const glm::vec3 &trueAcceleration, const glm::vec
     return glm::length(error) / glm::length(trueAcceleration);
 }
 
+TEST_CASE("Multipole moment translation", "[MultipoleMoment]") {
+
+    // Translating the moment of a point mass moves the point
+    REQUIRE(QuadrupoleMoment3f::FromPosition(glm::vec3{1, 2, 3}).translated(glm::vec3{1, -1, 2}) ==
+            QuadrupoleMoment3f::FromPosition(glm::vec3{2, 1, 5}));
+    REQUIRE(MultipoleMoment2f<6>::FromPosition(glm::vec2{1, 2}).translated(glm::vec2{-3, 1}) ==
+            MultipoleMoment2f<6>::FromPosition(glm::vec2{-2, 3}));
+    REQUIRE(MultipoleMoment3f<7>::FromPosition(glm::vec3{0, 1, -1}).translated(glm::vec3{2, 0, 1}) ==
+            MultipoleMoment3f<7>::FromPosition(glm::vec3{2, 1, 0}));
+
+    // Translation is linear, so the moments of several masses can be translated together
+    auto a = HexadecupoleMoment3f::FromPosition(glm::vec3{1, 2, 3}) * 2.0f;
+    auto b = HexadecupoleMoment3f::FromPosition(glm::vec3{-1, 0, 1}) * 3.0f;
+    auto offset = glm::vec3{1, 1, -2};
+    HexadecupoleMoment3f sum = a + b;
+    HexadecupoleMoment3f expected = HexadecupoleMoment3f::FromPosition(glm::vec3{2, 3, 1}) * 2.0f +
+                                    HexadecupoleMoment3f::FromPosition(glm::vec3{0, 1, -1}) * 3.0f;
+    REQUIRE(sum.translated(offset) == expected);
+
+    // A parent moment can be accumulated from its children
+    HexadecupoleMoment3f parent{};
+    parent.addTranslated(a, offset).addTranslated(b, offset);
+    REQUIRE(parent == expected);
+
+    // Translating about the center of mass removes the dipole
+    auto centerOfMass = to_glm(sum.tensor<1>()) / sum.scalar();
+    auto centered = sum.translated(-centerOfMass);
+    CHECK_THAT(centered.tensor<1>().norm(), Catch::Matchers::WithinAbs(0, 1e-5));
+    CHECK_THAT((centered.translated(centerOfMass).tensor<4>() - sum.tensor<4>()).norm(),
+               Catch::Matchers::WithinAbs(0, 1e-5 * sum.tensor<4>().norm()));
+}
+
 template<typename WorseApproximationFunction, typename BetterApproximationFunction>
 void compareAccuracy(WorseApproximationFunction worseApproximationFunction,
                      BetterApproximationFunction betterApproximationFunction) {
@@ -266,10 +352,7 @@ TEST_CASE("Higher order approximations should be more accurate", "[MultipoleMome
                 QuadrupoleMoment3f{}, std::plus<>{},
                 [&](auto particle) {
                     totalMass += particle.w;
-                    return QuadrupoleMoment3f::TracelessFromPosition(
-                            glm::vec3{particle},
-                            glm::length(glm::vec3(particle))
-                    ) * particle.w;
+                    return QuadrupoleMoment3f::TracelessFromPosition(glm::vec3{particle}) * particle.w;
                 }
         ) / totalMass;
     };
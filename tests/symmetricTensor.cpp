@@ -1,4 +1,5 @@
 #include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
 
 #include <symtensor/SymmetricTensor.h>
 #include <symtensor/glm.h>
@@ -9,6 +10,9 @@
 
 #include <iostream>
 #include <numeric>
+#include <sstream>
+
+#include <experimental/simd>
 
 using namespace symtensor;
 
@@ -172,6 +176,14 @@ TEST_CASE("Symmetric tensor comparison", "[SymmetricTensor]") {
     CHECK(s3a == s3a);
     CHECK(s3a != s3b);
 
+    SymmetricTensor3f<3> s3c = s3a + SymmetricTensor3f<3>::Ones();
+    CHECK(s3a <= s3a);
+    CHECK(s3a >= s3a);
+    CHECK(s3a < s3c);
+    CHECK(s3c > s3a);
+    CHECK(!(s3a < s3a));
+    CHECK(!(s3c <= s3a));
+
 }
 
 TEST_CASE("Symmetric tensor arithmetic", "[SymmetricTensor]") {
@@ -253,6 +265,35 @@ TEST_CASE("Symmetric tensor index format conversion", "[SymmetricTensor]") {
 
 }
 
+TEST_CASE("Symmetric tensor runtime flat indexing", "[SymmetricTensor]") {
+
+    // The table-based flat index should match the recursive definition for every index, in every order
+    [&]<std::size_t... R>(std::index_sequence<R...>) {
+        ([&]<std::size_t Rank>(std::integral_constant<std::size_t, Rank>) {
+            [&]<std::size_t... D>(std::index_sequence<D...>) {
+                ([&]<std::size_t Dimensions>(std::integral_constant<std::size_t, Dimensions>) {
+                    using Tensor = SymmetricTensor<float, Dimensions, Rank>;
+                    for (std::size_t i = 0; i < Tensor::NumValues; ++i) {
+                        auto index = Tensor::lexicographicalIndices(i);
+                        CHECK(tabulatedFlatIndex<Dimensions>(index) == flatIndex(index, Dimensions));
+                    }
+                }(std::integral_constant<std::size_t, D + 2>{}), ...);
+            }(std::make_index_sequence<3>());
+        }(std::integral_constant<std::size_t, R + 1>{}), ...);
+    }(std::make_index_sequence<6>());
+
+    // Flat indices are still usable at compile-time
+    STATIC_REQUIRE(SymmetricTensor3f<3>::flatIndex({Z, X, Y}) == 4);
+    STATIC_REQUIRE(SymmetricTensor3f<4>::flatIndex({Z, Z, Y, Z}) == 13);
+
+    // Indices can be converted in batches
+    using Octupole = SymmetricTensor3f<3>;
+    std::array<std::array<Octupole::Index, 3>, 4> indices{{{X, X, X}, {Z, Y, X}, {Y, Z, Y}, {Z, Z, Z}}};
+    std::array<std::size_t, 4> flatIndices{};
+    Octupole::flatIndices(indices, flatIndices);
+    CHECK(flatIndices == std::array<std::size_t, 4>{0, 4, 7, 9});
+}
+
 TEST_CASE("Symmetric tensor initialization with an expression", "[SymmetricTensor]") {
 
     auto ones = SymmetricTensor3f < 3 > ::NullaryExpression([]([[maybe_unused]] auto _) {
@@ -285,6 +326,164 @@ TEST_CASE("Trace of tensors of different sizes", "[SymmetricTensor]") {
     REQUIRE(SymmetricTensor3f<3>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9}.trace() == 15);
 }
 
+TEST_CASE("Partial trace of symmetric tensors", "[SymmetricTensor]") {
+
+    CHECK(SymmetricTensor3f<2>{0, 1, 2, 3, 4, 5}.trace<1>() == 8);
+    CHECK(SymmetricTensor3f<2>::Identity().trace<1>() == 3);
+    CHECK(SymmetricTensor3f<3>::CartesianPower(glm::vec3{1, 2, 3}).trace<1>() == SymmetricTensor3f<1>{14, 28, 42});
+
+    auto a = SymmetricTensor3f<4>::NullaryExpression([i = 0](auto) mutable { return static_cast<float>(i++); });
+    CHECK(a.trace<2>() == a.trace<1>().trace<1>());
+
+    // Compare with an explicit sum over the contracted indices
+    [&]<std::size_t... R>(std::index_sequence<R...>) {
+        ([&]<std::size_t D, std::size_t Rank, std::size_t K>(
+                std::integral_constant<std::size_t, D>,
+                std::integral_constant<std::size_t, Rank>,
+                std::integral_constant<std::size_t, K>
+        ) {
+            using Tensor = SymmetricTensor<double, D, Rank>;
+            using TraceTensor = SymmetricTensor<double, D, Rank - 2 * K>;
+            auto tensor = Tensor::NullaryExpression([i = 0](auto) mutable { return static_cast<double>(i++ % 7) - 3; });
+            auto trace = tensor.template trace<K>();
+            for (std::size_t i = 0; i < TraceTensor::NumUniqueValues; ++i) {
+                auto index = TraceTensor::dimensionalIndices(i);
+                double sum = 0;
+                std::array<std::size_t, K> traced{};
+                while (true) {
+                    std::array<typename Tensor::Index, Rank> fullIndex{};
+                    std::copy(index.begin(), index.end(), fullIndex.begin());
+                    for (std::size_t k = 0; k < K; ++k)
+                        fullIndex[Rank - 2 * k - 1] = fullIndex[Rank - 2 * k - 2] =
+                                static_cast<typename Tensor::Index>(traced[k]);
+                    sum += tensor[fullIndex];
+                    std::size_t k = 0;
+                    while (k < K && ++traced[k] == D) traced[k++] = 0;
+                    if (k == K) break;
+                }
+                CHECK(trace[i] == sum);
+            }
+        }(
+                std::integral_constant<std::size_t, 2 + R % 3>{},
+                std::integral_constant<std::size_t, 3 + R>{},
+                std::integral_constant<std::size_t, 1 + R / 3>{}
+        ), ...);
+    }(std::make_index_sequence<6>());
+}
+
+TEST_CASE("Traceless part of symmetric tensors", "[SymmetricTensor]") {
+
+    // A rank-2 tensor loses its trace from the diagonal
+    auto a = SymmetricTensor<float, 2, 2>{1, 2, 5};
+    CHECK(a.detrace() == SymmetricTensor<float, 2, 2>{-2, 2, 2});
+    CHECK(SymmetricTensor3f<2>::Identity().detrace() == SymmetricTensor3f<2>{});
+
+    // Vectors have no trace to remove
+    CHECK(SymmetricTensor3f<1>{1, 2, 3}.detrace() == SymmetricTensor3f<1>{1, 2, 3});
+
+    // Contracting any pair of indices of the result gives zero, and detracing again makes no difference
+    [&]<std::size_t... R>(std::index_sequence<R...>) {
+        ([&]<std::size_t D, std::size_t Rank>(
+                std::integral_constant<std::size_t, D>,
+                std::integral_constant<std::size_t, Rank>
+        ) {
+            using Tensor = SymmetricTensor<double, D, Rank>;
+            auto tensor = Tensor::NullaryExpression([i = 0](auto) mutable { return static_cast<double>(i++ % 7) - 3; });
+            auto traceless = tensor.detrace();
+            for (std::size_t i = 0; i < Tensor::NumUniqueValues; ++i) {
+                auto index = Tensor::dimensionalIndices(i);
+                double trace = 0;
+                for (std::size_t d = 0; d < D; ++d) {
+                    index[0] = index[1] = static_cast<typename Tensor::Index>(d);
+                    trace += traceless[index];
+                }
+                CHECK_THAT(trace, Catch::Matchers::WithinAbs(0, 1e-12 * tensor.norm()));
+            }
+            CHECK_THAT((traceless.detrace() - traceless).norm(), Catch::Matchers::WithinAbs(0, 1e-12 * tensor.norm()));
+        }(std::integral_constant<std::size_t, 2 + R % 3>{}, std::integral_constant<std::size_t, 2 + R>{}), ...);
+    }(std::make_index_sequence<7>());
+}
+
+TEST_CASE("Norm and inner product of symmetric tensors", "[SymmetricTensor]") {
+
+    // Off-diagonal elements appear twice in a full matrix
+    auto m = SymmetricTensor3f<2>{1, 2, 3, 4, 5, 6};
+    CHECK(m.norm2() == 1 + 2 * 4 + 2 * 9 + 16 + 2 * 25 + 36);
+    CHECK(m.norm() == std::sqrt(m.norm2()));
+    CHECK(dot(m, m) == m.norm2());
+    CHECK(dot(m, SymmetricTensor3f<2>::Identity()) == 1 + 4 + 6);
+    STATIC_REQUIRE(dot(SymmetricTensor3f<3>::Ones(), SymmetricTensor3f<3>::Ones()) == 27);
+
+    // Compare with a straightforward sum over every lexicographical index
+    [&]<std::size_t... R>(std::index_sequence<R...>) {
+        ([&]<std::size_t Rank>(std::integral_constant<std::size_t, Rank>) {
+            using Tensor = SymmetricTensor3f<Rank>;
+            auto a = Tensor::NullaryExpression([i = 0]([[maybe_unused]] auto _) mutable { return static_cast<float>(i++ % 7); });
+            auto b = Tensor::NullaryExpression([i = 0]([[maybe_unused]] auto _) mutable { return static_cast<float>(i++ % 5); });
+            float expectedDot = 0, expectedNorm2 = 0;
+            for (std::size_t i = 0; i < Tensor::NumValues; ++i) {
+                auto index = Tensor::lexicographicalIndices(i);
+                expectedDot += a[index] * b[index];
+                expectedNorm2 += a[index] * a[index];
+            }
+            CHECK(dot(a, b) == expectedDot);
+            CHECK(a.norm2() == expectedNorm2);
+        }(std::integral_constant<std::size_t, R + 1>{}), ...);
+    }(std::make_index_sequence<6>());
+}
+
+TEST_CASE("Large symmetric tensors", "[SymmetricTensor]") {
+
+    // These tensors are above SYMTENSOR_UNROLL_THRESHOLD, so loop-based implementations are used
+    auto check = [&]<typename Tensor, typename OtherTensor>() {
+        using ProductTensor = ReplaceRank<Tensor, Tensor::Rank - OtherTensor::Rank>;
+        constexpr std::size_t D = Tensor::Dimensions;
+        auto a = Tensor::NullaryExpression([](auto index) {
+            return static_cast<float>(flatIndex(index, D) % 7) - 3.0f;
+        });
+        auto b = OtherTensor::NullaryExpression([](auto index) {
+            return static_cast<float>(flatIndex(index, D) % 5) - 2.0f;
+        });
+        for (std::size_t i = 0; i < Tensor::NumUniqueValues; ++i)
+            REQUIRE(a[i] == static_cast<float>(i % 7) - 3.0f);
+
+        // Constructors
+        CHECK(Tensor::Identity().trace() == D);
+        CHECK(Tensor::Identity()[Tensor::dimensionalIndices(1)] == 0);
+        CHECK(Tensor::Ones() == Tensor::LexicographicalNullaryExpression([]([[maybe_unused]] auto) { return 1.0f; }));
+        auto v = ReplaceRank<Tensor, 1>::NullaryExpression([](auto index) {
+            return 1.0f + 0.5f * static_cast<float>(index[0]);
+        });
+        auto power = Tensor::CartesianPower(v);
+        auto index = Tensor::dimensionalIndices(Tensor::NumUniqueValues - 2);
+        float expectedPower = 1;
+        for (auto i: index) expectedPower *= v[static_cast<std::size_t>(i)];
+        CHECK(power[index] == expectedPower);
+
+        // Expressions
+        Tensor sum = a + a * 2.0f;
+        CHECK(sum == Tensor{(a * 3.0f).eval()});
+
+        // Norm & contraction, compared with straightforward sums over every lexicographical index
+        float expectedNorm2 = 0;
+        for (std::size_t i = 0; i < Tensor::NumValues; ++i)
+            expectedNorm2 += pow<2>(a[Tensor::lexicographicalIndices(i)]);
+        CHECK(a.norm2() == expectedNorm2);
+        auto expected = ProductTensor::NullaryExpression([&](auto productIndex) {
+            float sum = 0;
+            for (std::size_t j = 0; j < OtherTensor::NumValues; ++j) {
+                auto otherIndex = OtherTensor::lexicographicalIndices(j);
+                sum += a[concatenate(productIndex, otherIndex)] * b[otherIndex];
+            }
+            return sum;
+        });
+        CHECK(a * b == expected);
+    };
+    check.template operator()<SymmetricTensor3f<10>, SymmetricTensor3f<3>>();
+    check.template operator()<SymmetricTensor<float, 6, 4>, SymmetricTensor<float, 6, 2>>();
+    check.template operator()<SymmetricTensor<float, 8, 3>, SymmetricTensor<float, 8, 1>>();
+}
+
 TEST_CASE("Symmetric tensor promotion by cartesian product", "[SymmetricTensor]") {
 
     auto a = SymmetricTensor2f<1>{1, 2};
@@ -296,6 +495,54 @@ TEST_CASE("Symmetric tensor promotion by cartesian product", "[SymmetricTensor]"
     REQUIRE(aaaa == SymmetricTensor2f<4>::CartesianPower(a));
 }
 
+TEST_CASE("Symmetric outer product", "[SymmetricTensor]") {
+
+    auto v = SymmetricTensor3f<1>{1, 2, 3};
+    auto w = SymmetricTensor3f<1>{4, 5, 6};
+
+    // The outer product of two vectors is averaged with its transpose
+    CHECK(SymmetricTensor3f<2>::SymmetricOuterProduct(v, w) == SymmetricTensor3f<2>{4, 6.5, 9, 10, 13.5, 18});
+    CHECK(SymmetricTensor3f<2>::SymmetricOuterProduct(v, w) == SymmetricTensor3f<2>::SymmetricOuterProduct(w, v));
+
+    // Repeated products with the same vector reproduce the cartesian power
+    auto vv = SymmetricTensor3f<2>::SymmetricOuterProduct(v, v);
+    auto vvv = SymmetricTensor3f<3>::SymmetricOuterProduct(vv, v);
+    CHECK(vv == SymmetricTensor3f<2>::CartesianPower(v));
+    CHECK(vvv == SymmetricTensor3f<3>::CartesianPower(v));
+    auto v5 = SymmetricTensor3f<5>::CartesianPower(v);
+    CHECK_THAT((SymmetricTensor3f<5>::SymmetricOuterProduct(vv, vvv) - v5).norm(),
+               Catch::Matchers::WithinAbs(0, 1e-6 * v5.norm()));
+
+    // Compare with an average over every permutation of the index
+    [&]<std::size_t... R>(std::index_sequence<R...>) {
+        ([&]<std::size_t RankA, std::size_t RankB>(
+                std::integral_constant<std::size_t, RankA>,
+                std::integral_constant<std::size_t, RankB>
+        ) {
+            using TensorA = SymmetricTensor3f<RankA>;
+            using TensorB = SymmetricTensor3f<RankB>;
+            using ProductTensor = SymmetricTensor3f<RankA + RankB>;
+            auto a = TensorA::NullaryExpression([i = 0](auto) mutable { return static_cast<float>(i++ % 7); });
+            auto b = TensorB::NullaryExpression([i = 0](auto) mutable { return static_cast<float>(i++ % 5); });
+            auto product = ProductTensor::SymmetricOuterProduct(a, b);
+            for (std::size_t i = 0; i < ProductTensor::NumUniqueValues; ++i) {
+                auto index = ProductTensor::dimensionalIndices(i);
+                float sum = 0;
+                std::size_t count = 0;
+                do {
+                    std::array<Index<3>, RankA> indexA{};
+                    std::array<Index<3>, RankB> indexB{};
+                    std::copy(index.begin(), index.begin() + RankA, indexA.begin());
+                    std::copy(index.begin() + RankA, index.end(), indexB.begin());
+                    sum += a[indexA] * b[indexB];
+                    ++count;
+                } while (std::next_permutation(index.begin(), index.end()));
+                CHECK_THAT(product[i], Catch::Matchers::WithinRel(sum / static_cast<float>(count), 1e-6f));
+            }
+        }(std::integral_constant<std::size_t, R + 1>{}, std::integral_constant<std::size_t, 3 - R % 2>{}), ...);
+    }(std::make_index_sequence<5>());
+}
+
 TEST_CASE("Symmetric tensor product with a vector", "[SymmetricTensor]") {
 
     float v = 5;
@@ -317,3 +564,179 @@ TEST_CASE("Symmetric tensor product with a vector", "[SymmetricTensor]") {
     //    REQUIRE(SymmetricTensor3f<2>::Identity() * glm::vec3{0, 1, 2} ==
     //            SymmetricTensor3f<3>{0, 0, 0, 0, 0, 0, 1, 0, 1, 2});
 }
+
+TEST_CASE("Symmetric tensor contraction", "[SymmetricTensor]") {
+
+    // Matrix-vector product
+    auto m = SymmetricTensor3f<2>{1, 2, 3, 4, 5, 6};
+    auto v = SymmetricTensor3f<1>{1, 2, 3};
+    CHECK(m * v == SymmetricTensor3f<1>{14, 25, 31});
+
+    // Contracting tensors of the same rank produces a scalar
+    CHECK(v * v == 14);
+    CHECK(m * m == m.norm2());
+    STATIC_REQUIRE(SymmetricTensor3f<2>::Identity() * SymmetricTensor3f<2>::Ones() == 3);
+
+    // Off-diagonal elements of the result are only counted once
+    CHECK(SymmetricTensor3f<3>::Ones() * v == SymmetricTensor3f<2>::Ones() * 6.0f);
+    CHECK(SymmetricTensor3f<4>::Ones() * SymmetricTensor3f<2>::Ones() == SymmetricTensor3f<2>::Ones() * 9.0f);
+
+    // Compare with a straightforward sum over every lexicographical index
+    [&]<std::size_t... R>(std::index_sequence<R...>) {
+        ([&]<std::size_t Rank, std::size_t OtherRank>(
+                std::integral_constant<std::size_t, Rank>,
+                std::integral_constant<std::size_t, OtherRank>
+        ) {
+            using Tensor = SymmetricTensor3f<Rank>;
+            using OtherTensor = SymmetricTensor3f<OtherRank>;
+            using ProductTensor = SymmetricTensor3f<Rank - OtherRank>;
+            auto a = Tensor::NullaryExpression([i = 0]([[maybe_unused]] auto _) mutable { return static_cast<float>(i++ % 7); });
+            auto b = OtherTensor::NullaryExpression([i = 0]([[maybe_unused]] auto _) mutable { return static_cast<float>(i++ % 5); });
+            auto expected = ProductTensor::NullaryExpression([&](auto index) {
+                float sum = 0;
+                for (std::size_t j = 0; j < OtherTensor::NumValues; ++j) {
+                    auto otherIndex = OtherTensor::lexicographicalIndices(j);
+                    sum += a[Tensor::flatIndex(concatenate(index, otherIndex))] * b[OtherTensor::flatIndex(otherIndex)];
+                }
+                return sum;
+            });
+            CHECK(a * b == expected);
+        }(std::integral_constant<std::size_t, R + 2>{}, std::integral_constant<std::size_t, R / 2 + 1>{}), ...);
+    }(std::make_index_sequence<5>());
+}
+
+TEST_CASE("Symmetric tensor contraction with a vector", "[SymmetricTensor]") {
+
+    auto x = glm::vec3{1, 2, 3};
+    CHECK(SymmetricTensor3f<1>{1, 2, 3}.contract<1>(x) == 14);
+    CHECK(SymmetricTensor3f<2>::Identity().contract<1>(x) == SymmetricTensor3f<1>{1, 2, 3});
+    CHECK(SymmetricTensor3f<2>::Identity().contract<2>(x) == 14);
+    CHECK(SymmetricTensor3f<3>::Ones().contract<3>(x) == 216);
+
+    // Compare with contraction by the cartesian power of the vector
+    [&]<std::size_t... R>(std::index_sequence<R...>) {
+        ([&]<std::size_t D, std::size_t Rank, std::size_t K>(
+                std::integral_constant<std::size_t, D>,
+                std::integral_constant<std::size_t, Rank>,
+                std::integral_constant<std::size_t, K>
+        ) {
+            using Tensor = SymmetricTensor<double, D, Rank>;
+            using Vector = SymmetricTensor<double, D, 1>;
+            auto tensor = Tensor::NullaryExpression([i = 0](auto) mutable { return static_cast<double>(i++ % 7) - 3; });
+            auto vector = Vector::NullaryExpression([i = 0](auto) mutable { return static_cast<double>(i++ % 3) + 0.5; });
+            auto expected = tensor * ReplaceRank<Tensor, K>::CartesianPower(vector);
+            if constexpr (K == Rank)
+                CHECK_THAT(tensor.template contract<K>(vector), Catch::Matchers::WithinRel(expected, 1e-12));
+            else
+                CHECK_THAT((tensor.template contract<K>(vector) - expected).norm(),
+                           Catch::Matchers::WithinAbs(0, 1e-12 * expected.norm()));
+        }(
+                std::integral_constant<std::size_t, 2 + R % 3>{},
+                std::integral_constant<std::size_t, 2 + R>{},
+                std::integral_constant<std::size_t, 2 + R - R % 2>{}
+        ), ...);
+    }(std::make_index_sequence<8>());
+
+    // Contraction with many vectors at once matches contraction with each, both for table-driven contractions
+    // (spread over simd lanes, including the vectors which don't fill a full set) and for unrolled ones
+    std::vector<glm::vec3> points;
+    for (int n = 0; n < 37; ++n)
+        points.emplace_back(static_cast<float>(n % 5) - 2, 0.5f * static_cast<float>(n % 3), 1.0f);
+    auto tensor = SymmetricTensor3f<6>::NullaryExpression([i = 0](auto) mutable { return static_cast<float>(i++ % 7) - 3; });
+    auto large = SymmetricTensor3f<10>::NullaryExpression([i = 0](auto) mutable { return static_cast<float>(i++ % 5) - 2; });
+    std::vector<SymmetricTensor3f<2>> results(points.size());
+    std::vector<float> values(points.size()), largeValues(points.size());
+    tensor.contract<4>(std::span<const glm::vec3>{points}, std::span<SymmetricTensor3f<2>>{results});
+    tensor.contract<6>(std::span<const glm::vec3>{points}, std::span<float>{values});
+    large.contract<10>(std::span<const glm::vec3>{points}, std::span<float>{largeValues});
+    for (std::size_t n = 0; n < points.size(); ++n) {
+        CAPTURE(n);
+        const auto expected = tensor.contract<4>(points[n]);
+        CHECK_THAT((results[n] - expected).norm(), Catch::Matchers::WithinAbs(0, 1e-6 * expected.norm()));
+        const float value = tensor.contract<6>(points[n]), largeValue = large.contract<10>(points[n]);
+        CHECK_THAT(values[n], Catch::Matchers::WithinRel(value, 1e-5f) || Catch::Matchers::WithinAbs(value, 1e-5));
+        CHECK_THAT(largeValues[n],
+                   Catch::Matchers::WithinRel(largeValue, 1e-5f) || Catch::Matchers::WithinAbs(largeValue, 1e-5));
+    }
+}
+
+TEST_CASE("Lazy symmetric tensor expressions", "[SymmetricTensor]") {
+
+    SymmetricTensor3f<3> a{0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    SymmetricTensor3f<3> b = SymmetricTensor3f<3>::Ones();
+
+    // Chains of operators produce an expression, which is only evaluated when assigned to a tensor
+    auto expression = a + b * 2.0f - a / 2.0f;
+    STATIC_REQUIRE(tensor_expression<decltype(expression)>);
+    SymmetricTensor3f<3> result = expression;
+    CHECK(result == SymmetricTensor3f<3>{2, 2.5, 3, 3.5, 4, 4.5, 5, 5.5, 6, 6.5});
+    CHECK(expression == result);
+    CHECK(expression.eval() == result);
+    CHECK(2.0f * a == a * 2.0f);
+
+    // Temporaries are held by value, so expressions built from them remain valid
+    auto twos = SymmetricTensor3f<3>::Ones() * 2.0f;
+    CHECK(SymmetricTensor3f<3>{a + twos} == SymmetricTensor3f<3>{2, 3, 4, 5, 6, 7, 8, 9, 10, 11});
+
+    // Expressions are element-wise, so they may safely refer to the tensor being assigned to
+    SymmetricTensor3f<3> c = a;
+    c = c + c * 2.0f;
+    CHECK(c == a * 3.0f);
+    c += a - b;
+    CHECK(c == SymmetricTensor3f<3>{-1, 3, 7, 11, 15, 19, 23, 27, 31, 35});
+    c -= a * 4.0f;
+    CHECK(c == SymmetricTensor3f<3>{-1, -1, -1, -1, -1, -1, -1, -1, -1, -1});
+
+    // Expressions can be used in constant expressions
+    constexpr SymmetricTensor3f<2> q{0, 1, 2, 3, 4, 5};
+    constexpr SymmetricTensor3f<2> q3 = q * 2.0f + q;
+    STATIC_REQUIRE(q3 == SymmetricTensor3f<2>{0, 3, 6, 9, 12, 15});
+
+    // Other operations accept expressions
+    CHECK((a + b).norm2() == SymmetricTensor3f<3>{a + b}.norm2());
+    CHECK((a + b) * SymmetricTensor3f<1>{1, 0, 0} == SymmetricTensor3f<3>{a + b} * SymmetricTensor3f<1>{1, 0, 0});
+}
+
+TEST_CASE("Symmetric tensors with SIMD scalars", "[SymmetricTensor]") {
+
+    using SimdScalar = std::experimental::native_simd<float>;
+    using SimdSymmetricTensor3f3 = SymmetricTensor<SimdScalar, 3, 3>;
+
+    // Each lane holds a different tensor, lane l is (l + 1) times the scalar tensor
+    SymmetricTensor3f<3> s3{0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    auto lane = [](const SimdSymmetricTensor3f3 &tensor, std::size_t l) {
+        return SymmetricTensor3f<3>::NullaryExpression([&]<auto index>() { return tensor.template at<index>()[l]; });
+    };
+    auto simd_s3 = SimdSymmetricTensor3f3::NullaryExpression([&]<auto index>() {
+        return SimdScalar{[&](auto l) { return static_cast<float>(l + 1) * s3.at<index>(); }};
+    });
+
+    for (std::size_t l = 0; l < SimdScalar::size(); ++l)
+        CHECK(lane(simd_s3, l) == s3 * static_cast<float>(l + 1));
+
+    // Constructors
+    for (std::size_t l = 0; l < SimdScalar::size(); ++l) {
+        CHECK(lane(SimdSymmetricTensor3f3::Identity(), l) == SymmetricTensor3f<3>::Identity());
+        CHECK(lane(SimdSymmetricTensor3f3::Ones(), l) == SymmetricTensor3f<3>::Ones());
+        CHECK(lane(SimdSymmetricTensor3f3::Zeros(), l) == SymmetricTensor3f<3>::Zeros());
+    }
+
+    // Arithmetic is applied lane-wise
+    SimdSymmetricTensor3f3 simd_sum = simd_s3 + SimdSymmetricTensor3f3::Ones() * 2.0f;
+    simd_sum *= SimdScalar{3};
+    auto simd_norm2 = simd_s3.norm2();
+    for (std::size_t l = 0; l < SimdScalar::size(); ++l) {
+        CHECK(lane(simd_sum, l) == (s3 * static_cast<float>(l + 1) + SymmetricTensor3f<3>::Ones() * 2.0f) * 3.0f);
+        CHECK(simd_norm2[l] == (s3 * static_cast<float>(l + 1)).norm2());
+    }
+
+    // Equality requires every lane to match, ordering produces a mask
+    CHECK(simd_s3 == simd_s3);
+    CHECK(simd_s3 != simd_sum);
+    CHECK(all_of(simd_s3 <= simd_sum));
+    CHECK(none_of(simd_s3 > simd_sum));
+
+    std::stringstream stream;
+    stream << SymmetricTensor<SimdScalar, 3, 1>{SimdScalar{1}, SimdScalar{2}, SimdScalar{3}};
+    CHECK(stream.str().starts_with("[<1 1"));
+}
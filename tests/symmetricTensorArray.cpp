@@ -0,0 +1,118 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <symtensor/SymmetricTensorArray.h>
+
+#include <numeric>
+
+using namespace symtensor;
+
+// Workaround for compiler defect DR2621 in Clang 15
+// https://reviews.llvm.org/D134283
+#if (__cpp_using_enum && !__clang__) || (__clang_major__ > 15)
+using enum SymmetricTensor3f<1>::Index;
+#else
+using Index<3>::X;
+using Index<3>::Y;
+using Index<3>::Z;
+#endif
+
+TEST_CASE("Gather and scatter of symmetric tensors", "[SymmetricTensorArray]") {
+
+    SymmetricTensorArray3f<2> array{3};
+    REQUIRE(array.size() == 3);
+    CHECK(array.get(0) == SymmetricTensor3f<2>{});
+
+    array.set(1, SymmetricTensor3f<2>{0, 1, 2, 3, 4, 5});
+    CHECK(array.get(0) == SymmetricTensor3f<2>{});
+    CHECK(array.get(1) == SymmetricTensor3f<2>{0, 1, 2, 3, 4, 5});
+    CHECK(array[1] == SymmetricTensor3f<2>{0, 1, 2, 3, 4, 5});
+
+    array.push_back(SymmetricTensor3f<2>::Identity());
+    REQUIRE(array.size() == 4);
+    CHECK(array.get(3) == SymmetricTensor3f<2>::Identity());
+
+    std::vector<SymmetricTensor3f<2>> tensors{
+            SymmetricTensor3f<2>{0, 1, 2, 3, 4, 5},
+            SymmetricTensor3f<2>::Ones(),
+    };
+    SymmetricTensorArray3f<2> fromTensors{std::span<const SymmetricTensor3f<2>>{tensors}};
+    CHECK(fromTensors.get(0) == tensors[0]);
+    CHECK(fromTensors.get(1) == tensors[1]);
+}
+
+TEST_CASE("Member access to an array of symmetric tensors", "[SymmetricTensorArray]") {
+
+    SymmetricTensorArray3f<3> array{2};
+    array.set(1, SymmetricTensor3f<3>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9});
+
+    // Compile-time indexing matches the layout of a single tensor
+    CHECK(array.at<X, X, X>(1) == 0);
+    CHECK(array.at<X, Y, Z>(1) == 4);
+    CHECK(array.at<Z, Y, X>(1) == 4);
+    CHECK(array.at<Z, Z, Z>(1) == 9);
+
+    array.at<Y, Y, Z>(0) = 7;
+    CHECK(array.get(0).at<Y, Z, Y>() == 7);
+
+    // Each component is stored contiguously
+    auto xyz = array.component<X, Y, Z>();
+    REQUIRE(xyz.size() == 2);
+    CHECK(xyz[0] == 0);
+    CHECK(xyz[1] == 4);
+    CHECK(array.component(SymmetricTensor3f<3>::flatIndex<{X, Y, Z}>()).data() == xyz.data());
+}
+
+TEST_CASE("Bulk arithmetic on arrays of symmetric tensors", "[SymmetricTensorArray]") {
+
+    SymmetricTensor3f<2> a{0, 1, 2, 3, 4, 5};
+    SymmetricTensor3f<2> b{5, 4, 3, 2, 1, 0};
+
+    SymmetricTensorArray3f<2> as{}, bs{};
+    for (int i = 0; i < 5; ++i) {
+        as.push_back(a);
+        bs.push_back(b);
+    }
+
+    auto sum = as + bs;
+    for (std::size_t n = 0; n < sum.size(); ++n)
+        CHECK(sum.get(n) == a + b);
+
+    auto difference = as - bs;
+    for (std::size_t n = 0; n < difference.size(); ++n)
+        CHECK(difference.get(n) == a - b);
+
+    auto scaled = as * 2.0f;
+    for (std::size_t n = 0; n < scaled.size(); ++n)
+        CHECK(scaled.get(n) == a * 2.0f);
+
+    scaled /= 2.0f;
+    CHECK(scaled == as);
+
+    scaled += b;
+    CHECK(scaled == sum);
+    scaled -= b;
+    CHECK(scaled == as);
+
+    scaled += 1.0f;
+    CHECK(scaled.get(2) == a + 1.0f);
+    scaled -= 1.0f;
+    CHECK(scaled == as);
+
+    std::vector<float> weights{1, 2, 3, 4, 5};
+    scaled *= std::span<const float>{weights};
+    CHECK(scaled.get(4) == a * 5.0f);
+}
+
+TEST_CASE("Reductions over arrays of symmetric tensors", "[SymmetricTensorArray]") {
+
+    std::vector<SymmetricTensor3f<2>> tensors{};
+    for (int i = 0; i < 16; ++i)
+        tensors.push_back(SymmetricTensor3f<2>{0, 1, 2, 3, 4, 5} * float(i));
+    SymmetricTensorArray3f<2> array{std::span<const SymmetricTensor3f<2>>{tensors}};
+
+    CHECK(array.sum() == std::reduce(tensors.begin(), tensors.end()));
+
+    std::vector<float> weights(tensors.size(), 0.0f);
+    weights[3] = 2.0f;
+    CHECK(array.weightedSum(weights) == tensors[3] * 2.0f);
+}
@@ -0,0 +1,74 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+
+#include <symtensor/TracelessSymmetricTensor.h>
+
+using namespace symtensor;
+
+// Workaround for compiler defect DR2621 in Clang 15
+// https://reviews.llvm.org/D134283
+#if (__cpp_using_enum && !__clang__) || (__clang_major__ > 15)
+using enum SymmetricTensor3f<1>::Index;
+#else
+using Index<3>::X;
+using Index<3>::Y;
+using Index<3>::Z;
+#endif
+
+TEST_CASE("Traceless symmetric tensor storage", "[TracelessSymmetricTensor]") {
+
+    // In 3d, only 2R + 1 values are independent
+    STATIC_REQUIRE(TracelessSymmetricTensor3f<0>::NumIndependentValues == 1);
+    STATIC_REQUIRE(TracelessSymmetricTensor3f<1>::NumIndependentValues == 3);
+    STATIC_REQUIRE(TracelessSymmetricTensor3f<2>::NumIndependentValues == 5);
+    STATIC_REQUIRE(TracelessSymmetricTensor3f<8>::NumIndependentValues == 17);
+    STATIC_REQUIRE(sizeof(TracelessSymmetricTensor3f<8>) == 17 * sizeof(float));
+    STATIC_REQUIRE(TracelessSymmetricTensor<float, 2, 5>::NumIndependentValues == 2);
+
+    STATIC_REQUIRE(std::is_same_v<ReplaceRank<TracelessSymmetricTensor3f<2>, 4>, TracelessSymmetricTensor3f<4>>);
+    STATIC_REQUIRE(std::is_same_v<
+            ReplaceScalar<TracelessSymmetricTensor3f<2>, double>,
+            TracelessSymmetricTensor<double, 3, 2>
+    >);
+}
+
+TEST_CASE("Traceless symmetric tensor member access", "[TracelessSymmetricTensor]") {
+
+    auto quadrupole = TracelessSymmetricTensor3f<2>{SymmetricTensor3f<2>{-11, 6, 9, -2, 18, 13}};
+    CHECK(quadrupole == TracelessSymmetricTensor3f<2>{-11, 6, 9, -2, 18});
+
+    // The last diagonal element is reconstructed from the others
+    CHECK(quadrupole.at<X, X>() == -11);
+    CHECK(quadrupole.at<Y, Z>() == 18);
+    CHECK(quadrupole.at<Z, Z>() == 13);
+    CHECK(quadrupole[{Z, Z}] == 13);
+    CHECK(quadrupole[{Z, X}] == 9);
+    CHECK(quadrupole.expanded() == SymmetricTensor3f<2>{-11, 6, 9, -2, 18, 13});
+    CHECK(static_cast<SymmetricTensor3f<2>>(quadrupole) == SymmetricTensor3f<2>{-11, 6, 9, -2, 18, 13});
+}
+
+TEST_CASE("Traceless symmetric tensor conversion", "[TracelessSymmetricTensor]") {
+
+    [&]<std::size_t... R>(std::index_sequence<R...>) {
+        ([&]<std::size_t D, std::size_t Rank>(
+                std::integral_constant<std::size_t, D>,
+                std::integral_constant<std::size_t, Rank>
+        ) {
+            using Tensor = SymmetricTensor<double, D, Rank>;
+            using Traceless = TracelessSymmetricTensor<double, D, Rank>;
+            auto tensor = Tensor::NullaryExpression([i = 0](auto) mutable { return static_cast<double>(i++ % 7) - 3; })
+                    .detrace();
+
+            // Expanding a compressed traceless tensor reproduces the original
+            auto compressed = Traceless{tensor};
+            auto expanded = compressed.expanded();
+            CHECK_THAT((expanded - tensor).norm(), Catch::Matchers::WithinAbs(0, 1e-12 * tensor.norm()));
+            for (std::size_t i = 0; i < Tensor::NumUniqueValues; ++i)
+                CHECK(compressed[Tensor::dimensionalIndices(i)] == expanded[i]);
+
+            // Arithmetic on the independent values is consistent with arithmetic on the full tensor
+            auto sum = (compressed + compressed * 2.0 - compressed / 2.0).expanded();
+            CHECK_THAT((sum - tensor * 2.5).norm(), Catch::Matchers::WithinAbs(0, 1e-12 * tensor.norm()));
+        }(std::integral_constant<std::size_t, 2 + R % 3>{}, std::integral_constant<std::size_t, 1 + R>{}), ...);
+    }(std::make_index_sequence<8>());
+}
@@ -72,3 +72,47 @@ TEST_CASE("Convert simple function to lookup table", "[as_lookup_table]") {
 //    );
 
 }
+
+TEST_CASE("Number of unique permutations of a multiset", "[num_unique_permutations]") {
+
+    // All values distinct
+    STATIC_REQUIRE(num_unique_permutations(std::array<int, 1>{0}) == 1);
+    STATIC_REQUIRE(num_unique_permutations(std::array<int, 3>{0, 1, 2}) == 6);
+
+    // All values the same
+    STATIC_REQUIRE(num_unique_permutations(std::array<int, 4>{2, 2, 2, 2}) == 1);
+
+    // Mixed, these are the multinomial coefficients
+    STATIC_REQUIRE(num_unique_permutations(std::array<int, 3>{0, 0, 1}) == 3);
+    STATIC_REQUIRE(num_unique_permutations(std::array<int, 4>{0, 0, 1, 1}) == 6);
+    STATIC_REQUIRE(num_unique_permutations(std::array<int, 5>{0, 0, 1, 2, 2}) == 30);
+
+    // Order doesn't matter
+    STATIC_REQUIRE(num_unique_permutations(std::array<int, 5>{2, 0, 1, 2, 0}) == 30);
+
+    // Summed over every canonical index of a symmetric tensor, the weights cover every lexicographical index
+    auto total = [&]<std::size_t D, std::size_t R>() {
+        std::size_t sum = 0;
+        for (std::size_t i = 0; i < numUniqueValuesInSymmetricTensor(D, R); ++i)
+            sum += num_unique_permutations(dimensionalIndices<R, std::size_t>(i, D));
+        return sum;
+    };
+    CHECK(total.template operator()<3, 2>() == numValuesInTensor(3, 2));
+    CHECK(total.template operator()<3, 5>() == numValuesInTensor(3, 5));
+    CHECK(total.template operator()<4, 4>() == numValuesInTensor(4, 4));
+}
+
+TEST_CASE("Sum over every permutation of a set of values", "[deduplicated_sum]") {
+
+    // Each value is counted once for every distinct ordering of it
+    constexpr auto values = std::array{
+            std::array<int, 2>{0, 0},
+            std::array<int, 2>{0, 1},
+            std::array<int, 2>{1, 1}
+    };
+    STATIC_REQUIRE(deduplicated_sum<values>([]<auto>() { return 1; }) == 4);
+    STATIC_REQUIRE(deduplicated_sum<values>([]<auto v>() { return v[0] + v[1]; }) == 0 + 2 * 1 + 2);
+
+    // The result type is the type returned by the function
+    STATIC_REQUIRE(std::is_same_v<decltype(deduplicated_sum<values>([]<auto>() { return 1.0f; })), float>);
+}